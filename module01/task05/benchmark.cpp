@@ -0,0 +1,447 @@
+/* Замеры производительности сортировок из sort.h.
+ * Запуск: task05_benchmark [n] [каталог для временных файлов, по умолчанию $TMPDIR или /tmp]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <memory>
+
+#include "sort.h"
+#include "coverage_tree.h"
+#include "external_union.h"
+#include "point.h"
+#include "../task04/binary_heap.h"
+#include "../task07/radix_sort.h"
+
+#define DEFAULT_BENCHMARK_LENGTH 10000000
+
+typedef std::vector<int> array_t;
+
+template <typename F>
+double measure_seconds(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void print_result(const std::string &name, double seconds, double baseline) {
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3) << seconds << " s"
+              << std::setw(10) << std::setprecision(2) << baseline / seconds << "x" << std::endl;
+}
+
+array_t make_random_array(size_t n) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution;
+
+    array_t array(n);
+    for (auto &x : array) {
+        x = distribution(generator);
+    }
+    return array;
+}
+
+void check_sorted(const array_t &array, const array_t &expected) {
+    if (array != expected) {
+        std::cerr << "[sort result mismatch]" << std::endl;
+        std::exit(1);
+    }
+}
+
+void benchmark_parallel_merge_sort(const array_t &input) {
+    std::cout << "--- parallel_merge_sort, n = " << input.size() << " ---" << std::endl;
+
+    auto expected = input;
+    const auto baseline = measure_seconds([&]() {
+        merge_sort<int>(expected.data(), expected.size(), default_compare);
+    });
+    print_result("merge_sort", baseline, baseline);
+
+    const auto maxThreads = default_num_threads();
+    for (size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        auto array = input;
+        const auto seconds = measure_seconds([&]() {
+            parallel_merge_sort<int>(array.data(), array.size(), default_compare, numThreads);
+        });
+        check_sorted(array, expected);
+        print_result("parallel_merge_sort, threads = " + std::to_string(numThreads), seconds, baseline);
+    }
+}
+
+array_t make_nearly_sorted_array(size_t n, size_t numSwaps) {
+    std::mt19937 generator(7);
+
+    array_t array(n);
+    for (size_t i = 0; i < n; ++i) {
+        array[i] = static_cast<int>(i);
+    }
+    for (size_t i = 0; i < numSwaps && n > 1; ++i) {
+        std::swap(array[generator() % n], array[generator() % n]);
+    }
+    return array;
+}
+
+void benchmark_adaptive_merge_sort(const array_t &input, const std::string &name) {
+    std::cout << "--- adaptive_merge_sort, " << name << " ---" << std::endl;
+
+    auto expected = input;
+    const auto baseline = measure_seconds([&]() {
+        merge_sort<int>(expected.data(), expected.size(), default_compare);
+    });
+    print_result("merge_sort", baseline, baseline);
+
+    auto array = input;
+    const auto seconds = measure_seconds([&]() {
+        adaptive_merge_sort<int>(array.data(), array.size(), default_compare);
+    });
+    check_sorted(array, expected);
+    print_result("adaptive_merge_sort", seconds, baseline);
+}
+
+int compare_points(const point_t &left, const point_t &right) {
+    return left.x < right.x ? -1 : (right.x < left.x ? 1 : 0);
+}
+
+void benchmark_comparators(const array_t &input) {
+    std::cout << "--- merge_sort comparators, n = " << input.size() << " ---" << std::endl;
+
+    auto expected = input;
+    const auto baseline = measure_seconds([&]() {
+        merge_sort<int>(expected.data(), expected.size(), default_compare);
+    });
+    print_result("int, default_compare (pointer)", baseline, baseline);
+
+    auto array = input;
+    auto seconds = measure_seconds([&]() {
+        merge_sort(array.data(), array.size(), [](int left, int right) {
+            return left < right;
+        });
+    });
+    check_sorted(array, expected);
+    print_result("int, lambda (functor)", seconds, baseline);
+
+    std::vector<point_t> points(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        points[i].x = input[i];
+        points[i].isFirst = (i & 1) == 0;
+    }
+    auto pointsCopy = points;
+
+    const auto pointsBaseline = measure_seconds([&]() {
+        merge_sort<point_t>(points.data(), points.size(), compare_points);
+    });
+    print_result("point_t, three-way (pointer)", pointsBaseline, pointsBaseline);
+
+    seconds = measure_seconds([&]() {
+        merge_sort(pointsCopy.data(), pointsCopy.size(), [](const point_t &left, const point_t &right) {
+            return left.x < right.x;
+        });
+    });
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (points[i].x != pointsCopy[i].x || points[i].isFirst != pointsCopy[i].isFirst) {
+            std::cerr << "[sort result mismatch]" << std::endl;
+            std::exit(1);
+        }
+    }
+    print_result("point_t, lambda (functor)", seconds, pointsBaseline);
+}
+
+template <typename K>
+void benchmark_simd_sort(const std::vector<K> &input, const std::string &name) {
+    std::cout << "--- simd merge_sort, " << name << ", n = " << input.size() << " ---" << std::endl;
+
+    auto expected = input;
+    const auto baseline = measure_seconds([&]() {
+        merge_sort(expected.data(), expected.size(), [](K left, K right) {
+            return left < right;
+        });
+    });
+    print_result("scalar merge_sort", baseline, baseline);
+
+    auto array = input;
+    auto seconds = measure_seconds([&]() {
+        std::sort(array.begin(), array.end());
+    });
+    print_result("std::sort", seconds, baseline);
+
+    array = input;
+    seconds = measure_seconds([&]() {
+        merge_sort(array.data(), array.size());
+    });
+    if (array != expected) {
+        std::cerr << "[sort result mismatch]" << std::endl;
+        std::exit(1);
+    }
+    print_result(simd_sort_supported() ? "merge_sort (avx2)" : "merge_sort (no avx2)", seconds, baseline);
+}
+
+template <typename K>
+void benchmark_simd_sort(size_t n, const std::string &keyName) {
+    std::mt19937_64 generator(42);
+
+    std::vector<K> random(n);
+    for (auto &x : random) {
+        x = static_cast<K>(generator());
+    }
+    benchmark_simd_sort(random, keyName + " random");
+
+    auto sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    benchmark_simd_sort(sorted, keyName + " sorted");
+}
+
+int64_t count_union_length_by_sort(const std::vector<std::pair<int, int>> &segments) {
+    std::vector<point_t> points;
+    points.reserve(segments.size() * 2);
+    for (auto &segment : segments) {
+        points.push_back({segment.first, true});
+        points.push_back({segment.second, false});
+    }
+
+    merge_sort(points.data(), points.size(), [](const point_t &left, const point_t &right) {
+        return left.x < right.x;
+    });
+
+    int64_t length = 0;
+    size_t numOpen = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (numOpen) {
+            length += static_cast<int64_t>(points[i].x) - points[i - 1].x;
+        }
+        numOpen += points[i].isFirst ? 1 : -1;
+    }
+    return length;
+}
+
+void benchmark_coverage_tree(size_t numSegments, size_t numChanges) {
+    std::cout << "--- CoverageTree, " << numSegments << " segments, "
+              << numChanges << " changes ---" << std::endl;
+
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> coordinate(0, 1000000000);
+    auto random_segment = [&]() {
+        auto left = coordinate(generator), right = coordinate(generator);
+        return std::make_pair(std::min(left, right), std::max(left, right));
+    };
+
+    std::vector<std::pair<int, int>> segments(numSegments);
+    for (auto &segment : segments) {
+        segment = random_segment();
+    }
+
+    // Каждое изменение заменяет случайный отрезок новым, после чего запрашивается длина.
+    std::vector<std::pair<size_t, std::pair<int, int>>> changes(numChanges);
+    for (auto &change : changes) {
+        change = std::make_pair(generator() % numSegments, random_segment());
+    }
+
+    auto resorted = segments;
+    int64_t checksum = 0;
+    const auto baseline = measure_seconds([&]() {
+        for (auto &change : changes) {
+            resorted[change.first] = change.second;
+            checksum += count_union_length_by_sort(resorted);
+        }
+    });
+    print_result("re-sort after each change", baseline, baseline);
+
+    CoverageTree<int> tree;
+    for (auto &segment : segments) {
+        tree.AddSegment(segment.first, segment.second);
+    }
+
+    int64_t treeChecksum = 0;
+    const auto seconds = measure_seconds([&]() {
+        for (auto &change : changes) {
+            auto &segment = segments[change.first];
+            tree.RemoveSegment(segment.first, segment.second);
+            segment = change.second;
+            tree.AddSegment(segment.first, segment.second);
+            treeChecksum += static_cast<int64_t>(tree.CoveredLength());
+        }
+    });
+    if (checksum != treeChecksum) {
+        std::cerr << "[coverage mismatch]" << std::endl;
+        std::exit(1);
+    }
+    print_result("CoverageTree", seconds, baseline);
+}
+
+// Данные в 10 раз больше бюджета памяти, как при входе размером 10x RAM.
+void benchmark_external_union(size_t numSegments, const std::string &tempDirectory) {
+    const size_t dataSize = numSegments * 2 * sizeof(point_t);
+
+    external_config_t config;
+    config.memoryBudget = std::max<size_t>(dataSize / 10, 1);
+    config.tempDirectory = tempDirectory;
+
+    std::cout << "--- external union, " << numSegments << " segments, "
+              << dataSize / (1 << 20) << " MiB data, " << config.memoryBudget / (1 << 20)
+              << " MiB budget ---" << std::endl;
+
+    auto make_reader = [numSegments]() {
+        auto generator = std::make_shared<std::mt19937>(13);
+        auto numRead = std::make_shared<size_t>(0);
+        return [generator, numRead, numSegments](int &left, int &right) {
+            if (*numRead == numSegments) {
+                return false;
+            }
+            ++*numRead;
+            left = static_cast<int>((*generator)() % 1000000000);
+            right = left + static_cast<int>((*generator)() % 1000);
+            return true;
+        };
+    };
+
+    int64_t expected = 0;
+    const auto baseline = measure_seconds([&]() {
+        external_config_t inMemoryConfig;
+        inMemoryConfig.memoryBudget = (dataSize + sizeof(point_t) * 2) * 2;
+        expected = count_total_segment_length_external(make_reader(), inMemoryConfig);
+    });
+    print_result("in memory", baseline, baseline);
+
+    int64_t length = 0;
+    const auto seconds = measure_seconds([&]() {
+        length = count_total_segment_length_external(make_reader(), config);
+    });
+    if (length != expected) {
+        std::cerr << "[union length mismatch]" << std::endl;
+        std::exit(1);
+    }
+    print_result("external, budget = data / 10", seconds, baseline);
+}
+
+// Элемент кучи для слияния: BinaryHeap - куча на максимум, поэтому сравнения обращены.
+struct heap_head_t {
+    int key;
+    size_t run;
+
+    bool operator<=(const heap_head_t &other) const {
+        return key > other.key || (key == other.key && run >= other.run);
+    }
+    bool operator>(const heap_head_t &other) const {
+        return !(*this <= other);
+    }
+};
+
+void benchmark_kway_merge(const array_t &input) {
+    std::cout << "--- k-way merge, n = " << input.size() << " ---" << std::endl;
+
+    const size_t n = input.size();
+    for (size_t k = 2; k <= 1024 && k <= n; k <<= 1) {
+        auto runs = input;
+        std::vector<const int*> runPointers(k);
+        std::vector<size_t> runLengths(k);
+        for (size_t r = 0; r < k; ++r) {
+            const auto first = n * r / k, last = n * (r + 1) / k;
+            std::sort(runs.begin() + first, runs.begin() + last);
+            runPointers[r] = runs.data() + first;
+            runLengths[r] = last - first;
+        }
+
+        auto expected = runs;
+        const auto baseline = measure_seconds([&]() {
+            array_t temp(n);
+            for (size_t width = 1; width < k; width <<= 1) {
+                for (size_t r = 0; r + width < k; r += width << 1) {
+                    const auto first = n * r / k;
+                    const auto middle = n * (r + width) / k;
+                    const auto last = n * std::min(r + (width << 1), k) / k;
+                    merge(temp.data() + first, expected.data() + first, middle - first,
+                          expected.data() + middle, last - middle);
+                    std::copy(temp.begin() + first, temp.begin() + last, expected.begin() + first);
+                }
+            }
+        });
+        print_result("k = " + std::to_string(k) + ", pairwise merge", baseline, baseline);
+
+        array_t merged(n);
+        auto seconds = measure_seconds([&]() {
+            std::vector<size_t> positions(k);
+            BinaryHeap<heap_head_t> heap;
+            for (size_t r = 0; r < k; ++r) {
+                if (runLengths[r]) {
+                    heap.Add(heap_head_t{runPointers[r][positions[r]++], r});
+                }
+            }
+            for (size_t i = 0; !heap.IsEmpty(); ++i) {
+                auto head = heap.ExtractMax();
+                merged[i] = head.key;
+                if (positions[head.run] < runLengths[head.run]) {
+                    heap.Add(heap_head_t{runPointers[head.run][positions[head.run]++], head.run});
+                }
+            }
+        });
+        check_sorted(merged, expected);
+        print_result("k = " + std::to_string(k) + ", BinaryHeap", seconds, baseline);
+
+        seconds = measure_seconds([&]() {
+            kway_merge(runPointers.data(), runLengths.data(), k, merged.data());
+        });
+        check_sorted(merged, expected);
+        print_result("k = " + std::to_string(k) + ", LoserTree", seconds, baseline);
+    }
+}
+
+void benchmark_point_sort(size_t numPoints) {
+    std::cout << "--- points, n = " << numPoints << " ---" << std::endl;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(-1000000000, 1000000000);
+    std::vector<point_t> input(numPoints);
+    for (auto &point : input) {
+        point = {distribution(generator), static_cast<bool>(generator() & 1)};
+    }
+
+    auto expected = input;
+    const auto baseline = measure_seconds([&]() {
+        parallel_merge_sort(expected.data(), numPoints, point_less());
+    });
+    print_result("parallel_merge_sort, point_less", baseline, baseline);
+
+    auto points = input;
+    const auto seconds = measure_seconds([&]() {
+        lsd_sort_by_key(points.data(), numPoints, point_radix_key());
+    });
+    for (size_t i = 0; i < numPoints; ++i) {
+        if (points[i].x != expected[i].x || points[i].isFirst != expected[i].isFirst) {
+            std::cerr << "[sort result mismatch]" << std::endl;
+            std::exit(1);
+        }
+    }
+    print_result("lsd_sort_by_key, point_radix_key", seconds, baseline);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_BENCHMARK_LENGTH;
+
+    const auto input = make_random_array(n);
+    benchmark_comparators(input);
+    benchmark_simd_sort<int32_t>(n, "int32");
+    benchmark_simd_sort<int64_t>(n, "int64");
+    benchmark_parallel_merge_sort(input);
+    benchmark_point_sort(n);
+
+    auto sorted = make_nearly_sorted_array(n, 0);
+    auto reversed = sorted;
+    std::reverse(reversed.begin(), reversed.end());
+
+    benchmark_adaptive_merge_sort(input, "random");
+    benchmark_adaptive_merge_sort(sorted, "sorted");
+    benchmark_adaptive_merge_sort(reversed, "reversed");
+    benchmark_adaptive_merge_sort(make_nearly_sorted_array(n, n / 100), "1% swaps");
+
+    benchmark_kway_merge(input);
+
+    benchmark_coverage_tree(std::max<size_t>(n / 100, 1), 100);
+    benchmark_external_union(n, argc > 2 ? argv[2] : default_temp_directory());
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef COVERAGE_TREE_H
+#define COVERAGE_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <limits>
+#include <type_traits>
+
+// Динамическое дерево отрезков со счётчиками покрытия: поддерживает длину
+// объединения отрезков при добавлении и удалении за O(log C), где C - размер
+// диапазона координат. Узлы создаются по мере необходимости.
+// Длины считаются в uint64_t: для CoverageTree<int64_t> длина диапазона
+// по умолчанию равна 2^64 - 1 и в знаковый тип не помещается.
+template <typename T>
+class CoverageTree {
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(uint64_t),
+                  "CoverageTree: integer coordinates up to 64 bits only");
+
+    public:
+        typedef uint64_t length_t;
+
+        CoverageTree();
+        CoverageTree(T lowerBound, T upperBound);
+        CoverageTree(const CoverageTree &tree) = default;
+        CoverageTree(CoverageTree &&tree) noexcept = default;
+
+        ~CoverageTree() = default;
+
+        CoverageTree& operator=(const CoverageTree &tree) = default;
+        CoverageTree& operator=(CoverageTree &&tree) noexcept = default;
+
+        void AddSegment(T left, T right);
+        void RemoveSegment(T left, T right);
+
+        length_t CoveredLength() const;
+        size_t GetNumSegments() const;
+        bool IsEmpty() const;
+
+    private:
+        static const uint32_t NO_NODE = 0;
+
+        struct node_t {
+            uint32_t leftChild = NO_NODE;
+            uint32_t rightChild = NO_NODE;
+            int32_t coverCount = 0;
+            length_t coveredLength = 0;
+        };
+
+        T lowerBound;
+        T upperBound;
+        size_t numSegments = 0;
+
+        // Корень всегда имеет индекс 0, поэтому 0 обозначает отсутствие потомка.
+        std::vector<node_t> nodes = std::vector<node_t>(1);
+        std::vector<uint32_t> freeNodes;
+
+        void Update(uint32_t node, T first, T last, T left, T right, int32_t delta);
+        void FixLength(uint32_t node, T first, T last);
+
+        uint32_t CreateNode();
+        void ReleaseIfEmpty(uint32_t &node);
+
+        static length_t Distance(T first, T last);
+        static T Middle(T first, T last);
+};
+
+#include "coverage_tree.hpp"
+
+#endif //COVERAGE_TREE_H
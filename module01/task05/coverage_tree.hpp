@@ -0,0 +1,138 @@
+#ifndef COVERAGE_TREE_HPP
+#define COVERAGE_TREE_HPP
+
+#include <cassert>
+
+template<typename T>
+CoverageTree<T>::CoverageTree() :
+        lowerBound(std::numeric_limits<T>::min()), upperBound(std::numeric_limits<T>::max()) {
+    //NOP
+}
+
+template<typename T>
+CoverageTree<T>::CoverageTree(T lowerBound, T upperBound) : lowerBound(lowerBound), upperBound(upperBound) {
+    assert(lowerBound < upperBound);
+}
+
+template<typename T>
+void CoverageTree<T>::AddSegment(T left, T right) {
+    assert(lowerBound <= left && left <= right && right <= upperBound);
+
+    ++numSegments;
+    if (left < right) {
+        Update(0, lowerBound, upperBound, left, right, 1);
+    }
+}
+
+template<typename T>
+void CoverageTree<T>::RemoveSegment(T left, T right) {
+    assert(lowerBound <= left && left <= right && right <= upperBound);
+    assert(numSegments);
+
+    --numSegments;
+    if (left < right) {
+        Update(0, lowerBound, upperBound, left, right, -1);
+    }
+}
+
+template<typename T>
+typename CoverageTree<T>::length_t CoverageTree<T>::CoveredLength() const {
+    return nodes[0].coveredLength;
+}
+
+template<typename T>
+size_t CoverageTree<T>::GetNumSegments() const {
+    return numSegments;
+}
+
+template<typename T>
+bool CoverageTree<T>::IsEmpty() const {
+    return !numSegments;
+}
+
+// Узел node отвечает за полуинтервал [first, last).
+template<typename T>
+void CoverageTree<T>::Update(uint32_t node, T first, T last, T left, T right, int32_t delta) {
+    if (left <= first && last <= right) {
+        nodes[node].coverCount += delta;
+        // Удалять можно только ранее добавленный отрезок.
+        assert(nodes[node].coverCount >= 0);
+    }
+    else {
+        const auto middle = Middle(first, last);
+        if (left < middle) {
+            if (nodes[node].leftChild == NO_NODE) {
+                auto child = CreateNode();
+                nodes[node].leftChild = child;
+            }
+            Update(nodes[node].leftChild, first, middle, left, right, delta);
+            ReleaseIfEmpty(nodes[node].leftChild);
+        }
+        if (middle < right) {
+            if (nodes[node].rightChild == NO_NODE) {
+                auto child = CreateNode();
+                nodes[node].rightChild = child;
+            }
+            Update(nodes[node].rightChild, middle, last, left, right, delta);
+            ReleaseIfEmpty(nodes[node].rightChild);
+        }
+    }
+
+    FixLength(node, first, last);
+}
+
+template<typename T>
+void CoverageTree<T>::FixLength(uint32_t node, T first, T last) {
+    auto &current = nodes[node];
+    if (current.coverCount > 0) {
+        current.coveredLength = Distance(first, last);
+        return;
+    }
+
+    current.coveredLength = 0;
+    if (current.leftChild != NO_NODE) {
+        current.coveredLength += nodes[current.leftChild].coveredLength;
+    }
+    if (current.rightChild != NO_NODE) {
+        current.coveredLength += nodes[current.rightChild].coveredLength;
+    }
+}
+
+template<typename T>
+uint32_t CoverageTree<T>::CreateNode() {
+    if (!freeNodes.empty()) {
+        auto node = freeNodes.back();
+        freeNodes.pop_back();
+        return node;
+    }
+
+    assert(nodes.size() < std::numeric_limits<uint32_t>::max());
+    nodes.emplace_back();
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+// Возвращает в пул узел без покрытия и без потомков.
+template<typename T>
+void CoverageTree<T>::ReleaseIfEmpty(uint32_t &node) {
+    const auto &current = nodes[node];
+    if (current.coverCount || current.leftChild != NO_NODE || current.rightChild != NO_NODE) {
+        return;
+    }
+
+    nodes[node] = node_t();
+    freeNodes.push_back(node);
+    node = NO_NODE;
+}
+
+// Разность в беззнаковом типе верна и для знаковых T, даже если не помещается в T.
+template<typename T>
+typename CoverageTree<T>::length_t CoverageTree<T>::Distance(T first, T last) {
+    return static_cast<length_t>(last) - static_cast<length_t>(first);
+}
+
+template<typename T>
+T CoverageTree<T>::Middle(T first, T last) {
+    return static_cast<T>(static_cast<length_t>(first) + Distance(first, last) / 2);
+}
+
+#endif //COVERAGE_TREE_HPP
@@ -0,0 +1,70 @@
+#ifndef EXTERNAL_UNION_H
+#define EXTERNAL_UNION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "point.h"
+
+#define DEFAULT_EXTERNAL_MEMORY_BUDGET (64 << 20)
+#define DEFAULT_TEMP_DIRECTORY "/tmp"
+
+// Каталог для временных файлов: $TMPDIR, а если он не задан - /tmp.
+inline std::string default_temp_directory();
+
+typedef struct {
+    size_t memoryBudget = DEFAULT_EXTERNAL_MEMORY_BUDGET;
+    std::string tempDirectory = default_temp_directory();
+} external_config_t;
+
+// Длина объединения отрезков, которые не помещаются в память: концы сортируются
+// порциями в половину memoryBudget и сбрасываются во временные файлы, после чего
+// серии сливаются с одновременным подсчётом покрытой длины.
+// readSegment(left, right) возвращает false, когда отрезки закончились.
+template <typename F>
+int64_t count_total_segment_length_external(F &&readSegment, const external_config_t &config);
+
+// Подсчёт покрытой длины по упорядоченной последовательности концов.
+class SegmentSweep {
+    public:
+        void Add(const point_t &point);
+        int64_t GetLength() const;
+
+    private:
+        size_t numOpen = 0;
+        int lastX = 0;
+        int64_t length = 0;
+};
+
+// Временный файл с упорядоченной серией концов; удаляется в деструкторе.
+// Пишется целиком, закрывается и затем открывается для чтения.
+class RunFile {
+    public:
+        RunFile(const std::string &directory, size_t bufferSize);
+        RunFile(const RunFile &runFile) = delete;
+        RunFile(RunFile &&runFile) noexcept;
+
+        ~RunFile();
+
+        RunFile& operator=(const RunFile &runFile) = delete;
+        RunFile& operator=(RunFile &&runFile) = delete;
+
+        void Write(const point_t *points, size_t numPoints);
+        void FinishWriting();
+        void StartReading(size_t bufferSize);
+        bool Read(point_t &point);
+
+    private:
+        std::FILE *file = nullptr;
+        std::string path;
+        std::vector<char> buffer;
+
+        void SetBuffer(size_t bufferSize);
+};
+
+#include "external_union.hpp"
+
+#endif //EXTERNAL_UNION_H
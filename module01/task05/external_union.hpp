@@ -0,0 +1,200 @@
+#ifndef EXTERNAL_UNION_HPP
+#define EXTERNAL_UNION_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+
+#include "sort.h"
+#include "bad_input.h"
+
+#define MIN_EXTERNAL_BUFFER_POINTS 2
+#define EXTERNAL_MERGE_MAX_RUNS 64
+
+inline std::string default_temp_directory() {
+    const auto tempDirectory = std::getenv("TMPDIR");
+    return tempDirectory && *tempDirectory ? tempDirectory : DEFAULT_TEMP_DIRECTORY;
+}
+
+inline void SegmentSweep::Add(const point_t &point) {
+    if (numOpen) {
+        length += static_cast<int64_t>(point.x) - lastX;
+    }
+    assert(point.isFirst || numOpen);
+    numOpen += point.isFirst ? 1 : -1;
+    lastX = point.x;
+}
+
+inline int64_t SegmentSweep::GetLength() const {
+    return length;
+}
+
+// Имя выбирает mkstemp: файлы не совпадут ни у параллельных вызовов,
+// ни у других процессов с тем же каталогом.
+inline RunFile::RunFile(const std::string &directory, size_t bufferSize) {
+    path = directory + "/task05_run_XXXXXX";
+    const auto fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        path.clear();
+        throw std::runtime_error("Failed to create temporary file.");
+    }
+    file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        throw std::runtime_error("Failed to create temporary file.");
+    }
+    if (bufferSize) {
+        SetBuffer(bufferSize);
+    }
+}
+
+inline RunFile::RunFile(RunFile &&runFile) noexcept :
+        file(runFile.file), path(std::move(runFile.path)), buffer(std::move(runFile.buffer)) {
+    runFile.file = nullptr;
+    runFile.path.clear();
+}
+
+inline RunFile::~RunFile() {
+    if (file) {
+        std::fclose(file);
+    }
+    if (!path.empty()) {
+        std::remove(path.c_str());
+    }
+}
+
+inline void RunFile::Write(const point_t *points, size_t numPoints) {
+    if (std::fwrite(points, sizeof(point_t), numPoints, file) != numPoints) {
+        throw std::runtime_error("Failed to write temporary file.");
+    }
+}
+
+// Записанная серия закрывается, чтобы до слияния не держать открытыми
+// файлы всех серий.
+inline void RunFile::FinishWriting() {
+    const auto result = std::fclose(file);
+    file = nullptr;
+    if (result) {
+        throw std::runtime_error("Failed to write temporary file.");
+    }
+}
+
+// setvbuf допустим только до первой операции с потоком, поэтому файл
+// открывается заново.
+inline void RunFile::StartReading(size_t bufferSize) {
+    assert(!file);
+    file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("Failed to open temporary file.");
+    }
+    SetBuffer(bufferSize);
+}
+
+inline void RunFile::SetBuffer(size_t bufferSize) {
+    buffer.resize(std::max<size_t>(bufferSize, sizeof(point_t)));
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+}
+
+inline bool RunFile::Read(point_t &point) {
+    return std::fread(&point, sizeof(point_t), 1, file) == 1;
+}
+
+// Сливает серии runs в новую серию.
+inline RunFile merge_runs(std::vector<RunFile> &runs, const external_config_t &config) {
+    const auto bufferSize = config.memoryBudget / (runs.size() + 1);
+    for (auto &run : runs) {
+        run.StartReading(bufferSize);
+    }
+
+    RunFile merged(config.tempDirectory, bufferSize);
+    kway_merge_streams<point_t>(runs.size(), [&runs](size_t run, point_t &point) {
+        return runs[run].Read(point);
+    }, [&merged](const point_t &point) {
+        merged.Write(&point, 1);
+    }, point_less());
+    merged.FinishWriting();
+    return merged;
+}
+
+template <typename F>
+int64_t count_total_segment_length_external(F &&readSegment, const external_config_t &config) {
+    // Вторая половина бюджета - временный массив сортировки слиянием.
+    const auto bufferLength = std::max<size_t>(config.memoryBudget / 2 / sizeof(point_t),
+                                               MIN_EXTERNAL_BUFFER_POINTS) & ~size_t(1);
+    std::vector<point_t> points;
+    points.reserve(bufferLength);
+
+    std::vector<RunFile> runs;
+    bool isInputOver = false;
+
+    while (!isInputOver) {
+        points.clear();
+        int left = 0, right = 0;
+        while (points.size() < bufferLength) {
+            if (!readSegment(left, right)) {
+                isInputOver = true;
+                break;
+            }
+            if (right < left) {
+                throw bad_input("Second points of line segments should have greater coordinates than first ones.");
+            }
+            points.push_back({left, true});
+            points.push_back({right, false});
+        }
+
+        parallel_merge_sort(points.data(), points.size(), point_less());
+
+        // Всё поместилось в память - временные файлы не нужны.
+        if (isInputOver && runs.empty()) {
+            SegmentSweep sweep;
+            for (auto &point : points) {
+                sweep.Add(point);
+            }
+            return sweep.GetLength();
+        }
+
+        if (!points.empty()) {
+            runs.emplace_back(config.tempDirectory, 0);
+            runs.back().Write(points.data(), points.size());
+            runs.back().FinishWriting();
+        }
+    }
+
+    std::vector<point_t>().swap(points);
+
+    // Пока серий больше EXTERNAL_MERGE_MAX_RUNS, они сливаются группами,
+    // и открытых файлов не больше EXTERNAL_MERGE_MAX_RUNS + 1.
+    while (runs.size() > EXTERNAL_MERGE_MAX_RUNS) {
+        std::vector<RunFile> mergedRuns;
+        for (size_t first = 0; first < runs.size(); first += EXTERNAL_MERGE_MAX_RUNS) {
+            const auto last = std::min<size_t>(first + EXTERNAL_MERGE_MAX_RUNS, runs.size());
+
+            // Слитые серии удаляются вместе с group, а не после всего прохода.
+            std::vector<RunFile> group(std::make_move_iterator(runs.begin() + first),
+                                       std::make_move_iterator(runs.begin() + last));
+            mergedRuns.push_back(merge_runs(group, config));
+        }
+        runs = std::move(mergedRuns);
+    }
+
+    const auto readBufferSize = config.memoryBudget / std::max<size_t>(runs.size(), 1);
+    for (auto &run : runs) {
+        run.StartReading(readBufferSize);
+    }
+
+    SegmentSweep sweep;
+    kway_merge_streams<point_t>(runs.size(), [&runs](size_t run, point_t &point) {
+        return runs[run].Read(point);
+    }, [&sweep](const point_t &point) {
+        sweep.Add(point);
+    }, point_less());
+
+    return sweep.GetLength();
+}
+
+#endif //EXTERNAL_UNION_HPP
@@ -6,30 +6,53 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
 
 #include "sort.h"
+#include "point.h"
+#include "external_union.h"
 #include "bad_input.h"
 
 #define PRINT_ERROR(msg) \
     std::cout << msg;
 
-typedef struct {
-    int x;
-    bool isFirst;
-} point_t;
-
 int count_total_segment_length(point_t *points, size_t numPoints);
 
-int main() {
+// Разбор аргументов: --external [--memory-budget=<байт>] [--temp-dir=<путь>];
+// без --temp-dir временные файлы создаются в $TMPDIR или /tmp.
+bool parse_external_config(int argc, char *argv[], external_config_t &config);
+
+int main(int argc, char *argv[]) {
     size_t numSeg = 0;
     point_t *points = nullptr;
 
     try {
+        external_config_t externalConfig;
+        const auto isExternal = parse_external_config(argc, argv, externalConfig);
+
         std::cin >> numSeg;
         if (!numSeg) {
             throw bad_input("Number of line segments should be greater than 0.");
         }
 
+        if (isExternal) {
+            size_t numRead = 0;
+            const auto segLength = count_total_segment_length_external([&](int &left, int &right) {
+                if (numRead == numSeg) {
+                    return false;
+                }
+                if (!(std::cin >> left >> right)) {
+                    throw bad_input("Unexpected end of input.");
+                }
+                ++numRead;
+                return true;
+            }, externalConfig);
+            std::cout << segLength;
+            return 0;
+        }
+
 	    const auto numPoints = numSeg << 1;
 	    points = new point_t[numPoints];
 
@@ -56,6 +79,9 @@ int main() {
     catch (bad_input &exc) {
         PRINT_ERROR(exc.what());
     }
+    catch (std::runtime_error &exc) {
+        PRINT_ERROR(exc.what());
+    }
     catch (...) {
         PRINT_ERROR("[error]");
     }
@@ -66,9 +92,7 @@ int main() {
 int count_total_segment_length(point_t *points, size_t numPoints) {
     assert(points && numPoints);
 
-    merge_sort<point_t>(points, numPoints, [](const point_t &left, const point_t &right) -> int {
-        return left.x - right.x;
-    });
+    parallel_merge_sort(points, numPoints, point_less());
 
     // Первая точка обязательно должна быть началом отрезка.
     assert(points[0].isFirst);
@@ -84,4 +108,29 @@ int count_total_segment_length(point_t *points, size_t numPoints) {
     }
 
     return segLength;
-}
\ No newline at end of file
+}
+
+bool parse_external_config(int argc, char *argv[], external_config_t &config) {
+    static const char MEMORY_BUDGET_ARG[] = "--memory-budget=";
+    static const char TEMP_DIR_ARG[] = "--temp-dir=";
+
+    bool isExternal = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--external")) {
+            isExternal = true;
+        }
+        else if (!strncmp(argv[i], MEMORY_BUDGET_ARG, sizeof(MEMORY_BUDGET_ARG) - 1)) {
+            config.memoryBudget = std::strtoull(argv[i] + sizeof(MEMORY_BUDGET_ARG) - 1, nullptr, 10);
+            if (!config.memoryBudget) {
+                throw bad_input("Memory budget should be greater than 0.");
+            }
+        }
+        else if (!strncmp(argv[i], TEMP_DIR_ARG, sizeof(TEMP_DIR_ARG) - 1)) {
+            config.tempDirectory = argv[i] + sizeof(TEMP_DIR_ARG) - 1;
+        }
+        else {
+            throw bad_input("Usage: task05 [--external [--memory-budget=<bytes>] [--temp-dir=<path>]]");
+        }
+    }
+    return isExternal;
+}
@@ -0,0 +1,27 @@
+#ifndef POINT_H
+#define POINT_H
+
+#include <cstdint>
+
+typedef struct {
+    int x;
+    bool isFirst;
+} point_t;
+
+// При равных координатах начала отрезков идут раньше концов.
+struct point_less {
+    bool operator()(const point_t &left, const point_t &right) const {
+        return left.x < right.x || (left.x == right.x && left.isFirst && !right.isFirst);
+    }
+};
+
+// Ключ поразрядной сортировки с тем же порядком, что у point_less: координата
+// со сдвинутым знаковым битом, младший бит - 0 у начала отрезка.
+struct point_radix_key {
+    uint64_t operator()(const point_t &point) const {
+        const auto x = static_cast<uint32_t>(point.x) ^ 0x80000000u;
+        return (static_cast<uint64_t>(x) << 1) | (point.isFirst ? 0 : 1);
+    }
+};
+
+#endif //POINT_H
@@ -0,0 +1,268 @@
+#ifndef SIMD_SORT_H
+#define SIMD_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+#include <algorithm>
+
+// Векторная сортировка слиянием для 32- и 64-битных целых ключей на AVX2:
+// блоки сортируются сетями сортировки в регистрах, затем серии сливаются
+// битонным слиянием пар регистров. Наличие AVX2 проверяется во время выполнения.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_SORT_AVAILABLE 1
+#include <immintrin.h>
+#define SIMD_SORT_TARGET __attribute__((target("avx2")))
+#else
+#define SIMD_SORT_AVAILABLE 0
+#endif
+
+#define SIMD_SORT_MIN_LENGTH 128
+
+template <typename T>
+struct has_simd_sort : std::integral_constant<bool, SIMD_SORT_AVAILABLE &&
+        (std::is_same<T, int32_t>::value || std::is_same<T, int64_t>::value)> {
+};
+
+#if SIMD_SORT_AVAILABLE
+
+inline bool simd_sort_supported() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// ----------------------------- int32_t, 8 элементов в регистре -----------------------------
+
+struct simd_int32_traits {
+    typedef int32_t key_t;
+    static const size_t WIDTH = 8;
+    static const size_t BLOCK_LENGTH = WIDTH * WIDTH;
+};
+
+SIMD_SORT_TARGET inline void simd_compare_exchange(__m256i &a, __m256i &b, int32_t) {
+    auto minimum = _mm256_min_epi32(a, b);
+    b = _mm256_max_epi32(a, b);
+    a = minimum;
+}
+
+// Сортирует битонную последовательность внутри регистра: шаги 4, 2, 1.
+SIMD_SORT_TARGET inline __m256i simd_bitonic_clean(__m256i v, int32_t) {
+    auto t = _mm256_permute2x128_si256(v, v, 0x01);
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xF0);
+    t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xCC);
+    t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xAA);
+}
+
+SIMD_SORT_TARGET inline __m256i simd_reverse(__m256i v, int32_t) {
+    return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+SIMD_SORT_TARGET inline void simd_transpose(__m256i *r, int32_t) {
+    __m256i t[8], u[8];
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+// Сортирует 64 элемента: сеть сортировки на 8 входов (19 компараторов) по столбцам
+// и транспонирование дают 8 упорядоченных серий по 8 элементов.
+SIMD_SORT_TARGET inline void simd_sort_block(int32_t *block) {
+    __m256i r[8];
+    for (int i = 0; i < 8; ++i) {
+        r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block) + i);
+    }
+
+    static const int network[19][2] = {
+        {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7},
+        {0, 1}, {2, 3}, {4, 5}, {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6},
+        {1, 2}, {3, 4}, {5, 6}
+    };
+    for (auto &comparator : network) {
+        simd_compare_exchange(r[comparator[0]], r[comparator[1]], int32_t());
+    }
+
+    simd_transpose(r, int32_t());
+    for (int i = 0; i < 8; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block) + i, r[i]);
+    }
+}
+
+// ----------------------------- int64_t, 4 элемента в регистре -----------------------------
+
+struct simd_int64_traits {
+    typedef int64_t key_t;
+    static const size_t WIDTH = 4;
+    static const size_t BLOCK_LENGTH = WIDTH * WIDTH;
+};
+
+SIMD_SORT_TARGET inline __m256i simd_min_epi64(__m256i a, __m256i b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+}
+
+SIMD_SORT_TARGET inline __m256i simd_max_epi64(__m256i a, __m256i b) {
+    return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+}
+
+SIMD_SORT_TARGET inline void simd_compare_exchange(__m256i &a, __m256i &b, int64_t) {
+    auto greater = _mm256_cmpgt_epi64(a, b);
+    auto minimum = _mm256_blendv_epi8(a, b, greater);
+    b = _mm256_blendv_epi8(b, a, greater);
+    a = minimum;
+}
+
+SIMD_SORT_TARGET inline __m256i simd_bitonic_clean(__m256i v, int64_t) {
+    auto t = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(simd_min_epi64(v, t), simd_max_epi64(v, t), 0xF0);
+    t = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_blend_epi32(simd_min_epi64(v, t), simd_max_epi64(v, t), 0xCC);
+}
+
+SIMD_SORT_TARGET inline __m256i simd_reverse(__m256i v, int64_t) {
+    return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+SIMD_SORT_TARGET inline void simd_sort_block(int64_t *block) {
+    __m256i r[4];
+    for (int i = 0; i < 4; ++i) {
+        r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block) + i);
+    }
+
+    simd_compare_exchange(r[0], r[1], int64_t());
+    simd_compare_exchange(r[2], r[3], int64_t());
+    simd_compare_exchange(r[0], r[2], int64_t());
+    simd_compare_exchange(r[1], r[3], int64_t());
+    simd_compare_exchange(r[1], r[2], int64_t());
+
+    auto t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+    auto t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+    auto t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+    auto t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+    r[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    r[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    r[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    r[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+
+    for (int i = 0; i < 4; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block) + i, r[i]);
+    }
+}
+
+// ----------------------------- Общая часть -----------------------------
+
+// Битонное слияние двух упорядоченных регистров: в low - меньшая половина, в high - большая.
+template <typename K>
+SIMD_SORT_TARGET inline void simd_bitonic_merge(__m256i &low, __m256i &high) {
+    high = simd_reverse(high, K());
+    simd_compare_exchange(low, high, K());
+    low = simd_bitonic_clean(low, K());
+    high = simd_bitonic_clean(high, K());
+}
+
+template <typename Traits>
+SIMD_SORT_TARGET void simd_merge_runs(const typename Traits::key_t *first, size_t firstLength,
+        const typename Traits::key_t *second, size_t secondLength, typename Traits::key_t *result) {
+    typedef typename Traits::key_t key_t;
+    const size_t width = Traits::WIDTH;
+    assert(firstLength % width == 0 && secondLength % width == 0);
+
+    if (!firstLength || !secondLength) {
+        memcpy(result, firstLength ? first : second, (firstLength + secondLength) * sizeof(key_t));
+        return;
+    }
+
+    auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second));
+    size_t i = width, j = width;
+
+    simd_bitonic_merge<key_t>(low, high);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result), low);
+    result += width;
+
+    while (i < firstLength || j < secondLength) {
+        // Следующим берём блок той серии, чей первый элемент меньше.
+        if (j == secondLength || (i < firstLength && first[i] <= second[j])) {
+            low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+            i += width;
+        }
+        else {
+            low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + j));
+            j += width;
+        }
+
+        simd_bitonic_merge<key_t>(low, high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result), low);
+        result += width;
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result), high);
+}
+
+template <typename Traits>
+SIMD_SORT_TARGET void simd_merge_sort_impl(typename Traits::key_t *array, size_t arrayLength) {
+    typedef typename Traits::key_t key_t;
+    const size_t blockLength = Traits::BLOCK_LENGTH;
+
+    // Хвост дополняется максимальными значениями до целого числа блоков.
+    const auto paddedLength = (arrayLength + blockLength - 1) / blockLength * blockLength;
+    auto *source = new key_t[paddedLength];
+    auto *target = new key_t[paddedLength];
+
+    memcpy(source, array, arrayLength * sizeof(key_t));
+    for (auto i = arrayLength; i < paddedLength; ++i) {
+        source[i] = std::numeric_limits<key_t>::max();
+    }
+
+    for (size_t i = 0; i < paddedLength; i += blockLength) {
+        simd_sort_block(source + i);
+    }
+
+    for (size_t runLength = Traits::WIDTH; runLength < paddedLength; runLength <<= 1) {
+        for (size_t first = 0; first < paddedLength; first += runLength << 1) {
+            const auto middle = std::min(first + runLength, paddedLength);
+            const auto last = std::min(middle + runLength, paddedLength);
+            simd_merge_runs<Traits>(source + first, middle - first, source + middle, last - middle, target + first);
+        }
+        std::swap(source, target);
+    }
+
+    memcpy(array, source, arrayLength * sizeof(key_t));
+    delete[] source;
+    delete[] target;
+}
+
+inline void simd_merge_sort(int32_t *array, size_t arrayLength) {
+    assert(simd_sort_supported());
+    simd_merge_sort_impl<simd_int32_traits>(array, arrayLength);
+}
+
+inline void simd_merge_sort(int64_t *array, size_t arrayLength) {
+    assert(simd_sort_supported());
+    simd_merge_sort_impl<simd_int64_traits>(array, arrayLength);
+}
+
+#else
+
+inline bool simd_sort_supported() {
+    return false;
+}
+
+#endif //SIMD_SORT_AVAILABLE
+
+#endif //SIMD_SORT_H
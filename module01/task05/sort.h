@@ -2,8 +2,20 @@
 #define SORT_H
 
 #include <cstddef>
+#include <cstdint>
 #include <cassert>
 #include <cstring>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "simd_sort.h"
+
+#define PARALLEL_MERGE_SORT_MIN_LENGTH 8192
+#define SIMD_SORT_MIN_PRESORTED_RUN 64
 
 template <typename T>
 int default_compare(const T &first, const T &second) {
@@ -11,9 +23,43 @@ int default_compare(const T &first, const T &second) {
 }
 
 template <typename T>
+struct default_less {
+    bool operator()(const T &left, const T &right) const {
+        return left < right;
+    }
+};
+
+// Адаптер для трёхзначных функций сравнения: сортировки ниже принимают
+// предикат "меньше", который компилятор может встроить.
+template <typename T>
+class ThreeWayLess {
+    public:
+        explicit ThreeWayLess(int (*compare_f)(const T &left, const T &right)) : compare_f(compare_f) {
+            assert(compare_f);
+        }
+
+        bool operator()(const T &left, const T &right) const {
+            return compare_f(left, right) < 0;
+        }
+
+    private:
+        int (*compare_f)(const T &left, const T &right) = nullptr;
+};
+
+template <typename T, typename Compare>
+struct is_less_predicate : std::is_same<
+        decltype(std::declval<Compare&>()(std::declval<const T&>(), std::declval<const T&>())), bool> {
+};
+
+#define ASSERT_LESS_PREDICATE(T, Compare) \
+    static_assert(is_less_predicate<T, Compare>::value, \
+                  "Compare should be a \"less\" predicate returning bool.")
+
+template <typename T, typename Compare = default_less<T>>
 void merge(T *result, T *first, const size_t firstLength, T *second, const size_t secondLength,
-        int (*compare_f)(const T &left, const T &right) = default_compare) {
-    assert(result && first && second && firstLength && secondLength);
+        Compare less = Compare()) {
+    ASSERT_LESS_PREDICATE(T, Compare);
+    assert(result && (first || !firstLength) && (second || !secondLength));
 
     size_t firstIndex = 0;
     size_t secondIndex = 0;
@@ -26,31 +72,808 @@ void merge(T *result, T *first, const size_t firstLength, T *second, const size_
         else if (secondIndex == secondLength) {
             result[i] = first[firstIndex++];
         }
-        else if (compare_f(first[firstIndex], second[secondIndex]) < 0) {
-            result[i] = first[firstIndex++];
+        else if (less(second[secondIndex], first[firstIndex])) {
+            // При равенстве берём элемент из первой половины - сортировка устойчива.
+            result[i] = second[secondIndex++];
         }
         else {
-            result[i] = second[secondIndex++];
+            result[i] = first[firstIndex++];
         }
     }
 }
 
 template <typename T>
-void merge_sort(T *array, size_t arrayLength, int (*compare_f)(const T &left, const T &right)) {
+void merge(T *result, T *first, const size_t firstLength, T *second, const size_t secondLength,
+        int (*compare_f)(const T &left, const T &right)) {
+    merge(result, first, firstLength, second, secondLength, ThreeWayLess<T>(compare_f));
+}
+
+// Для целых ключей с естественным порядком выбирается векторная сортировка.
+template <typename T, typename Compare>
+struct use_simd_sort : std::integral_constant<bool,
+        has_simd_sort<T>::value && std::is_same<Compare, default_less<T>>::value> {
+};
+
+template <typename T, typename Compare = default_less<T>>
+void adaptive_merge_sort(T *array, size_t arrayLength, Compare less = Compare());
+
+// Серии длиннее в среднем SIMD_SORT_MIN_PRESORTED_RUN: при случайном входе
+// проход обрывается примерно на arrayLength / 32 элементе.
+template <typename T, typename Compare>
+bool is_presorted(const T *array, size_t arrayLength, Compare less) {
+    const auto maxDescents = arrayLength / SIMD_SORT_MIN_PRESORTED_RUN;
+    size_t numDescents = 0;
+    for (size_t i = 1; i < arrayLength; ++i) {
+        numDescents += less(array[i], array[i - 1]);
+        if (numDescents > maxDescents) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Compare>
+bool try_simd_sort(T *, size_t, Compare, std::false_type) {
+    return false;
+}
+
+// Векторная сортировка не использует готовые серии: упорядоченный int64 она
+// сортирует медленнее скалярной, а адаптивная сортировка - за один проход.
+template <typename T, typename Compare>
+bool try_simd_sort(T *array, size_t arrayLength, Compare less, std::true_type) {
+    if (arrayLength < SIMD_SORT_MIN_LENGTH || !simd_sort_supported()) {
+        return false;
+    }
+    if (is_presorted(array, arrayLength, less)) {
+        adaptive_merge_sort(array, arrayLength, less);
+    }
+    else {
+        simd_merge_sort(array, arrayLength);
+    }
+    return true;
+}
+
+template <typename T, typename Compare = default_less<T>>
+void merge_sort(T *array, size_t arrayLength, Compare less = Compare()) {
+    ASSERT_LESS_PREDICATE(T, Compare);
     if (arrayLength <= 1) {
         return;
     }
+    if (try_simd_sort(array, arrayLength, less, use_simd_sort<T, Compare>())) {
+        return;
+    }
 
 	auto firstLength = arrayLength / 2;
 	auto secondLength = arrayLength - firstLength;
 
-    merge_sort(array, firstLength, compare_f);
-    merge_sort(array + firstLength, secondLength, compare_f);
+    merge_sort(array, firstLength, less);
+    merge_sort(array + firstLength, secondLength, less);
 
     auto *temp = new T[arrayLength];
-    merge<T>(temp, array, firstLength, array + firstLength, secondLength, compare_f);
+    merge(temp, array, firstLength, array + firstLength, secondLength, less);
     memcpy(array, temp, sizeof(T) * arrayLength);
     delete[] temp;
 }
 
+template <typename T>
+void merge_sort(T *array, size_t arrayLength, int (*compare_f)(const T &left, const T &right)) {
+    merge_sort(array, arrayLength, ThreeWayLess<T>(compare_f));
+}
+
+#define MIN_MERGE_RUN_LENGTH 64
+#define MIN_GALLOP 7
+
+// Адаптивная сортировка слиянием естественных серий (TimSort):
+// на почти упорядоченных данных работает за время, близкое к O(n).
+template <typename T, typename Compare>
+class AdaptiveMergeSorter {
+    public:
+        AdaptiveMergeSorter(T *array, size_t arrayLength, Compare less);
+
+        void Sort();
+
+    private:
+        struct run_t {
+            size_t first;
+            size_t length;
+        };
+
+        T *array = nullptr;
+        size_t arrayLength = 0;
+        Compare less;
+
+        std::vector<T> temp;
+        std::vector<run_t> runs;
+        size_t minGallop = MIN_GALLOP;
+
+        bool Less(const T &left, const T &right) const;
+
+        size_t CountRunAndMakeAscending(size_t first, size_t last);
+        void BinaryInsertionSort(size_t first, size_t last, size_t start);
+
+        template <bool countEqual>
+        size_t Gallop(const T &key, const T *items, size_t numItems, bool fromEnd) const;
+
+        void MergeCollapse();
+        void MergeForceCollapse();
+        void MergeAt(size_t index);
+        void MergeLow(size_t first, size_t firstLength, size_t second, size_t secondLength);
+        void MergeHigh(size_t first, size_t firstLength, size_t second, size_t secondLength);
+
+        static size_t ComputeMinRun(size_t length);
+};
+
+template <typename T, typename Compare>
+AdaptiveMergeSorter<T, Compare>::AdaptiveMergeSorter(T *array, size_t arrayLength, Compare less) :
+        array(array), arrayLength(arrayLength), less(less) {
+    assert(array || !arrayLength);
+}
+
+template <typename T, typename Compare>
+void AdaptiveMergeSorter<T, Compare>::Sort() {
+    if (arrayLength < 2) {
+        return;
+    }
+
+    const auto minRun = ComputeMinRun(arrayLength);
+
+    size_t first = 0;
+    while (first < arrayLength) {
+        auto runLength = CountRunAndMakeAscending(first, arrayLength);
+
+        // Короткие серии дополняются до minRun сортировкой вставками.
+        if (runLength < minRun) {
+            const auto forcedLength = std::min(minRun, arrayLength - first);
+            BinaryInsertionSort(first, first + forcedLength, first + runLength);
+            runLength = forcedLength;
+        }
+
+        runs.push_back({first, runLength});
+        MergeCollapse();
+
+        first += runLength;
+    }
+
+    MergeForceCollapse();
+    assert(runs.size() == 1 && runs[0].length == arrayLength);
+}
+
+template <typename T, typename Compare>
+inline bool AdaptiveMergeSorter<T, Compare>::Less(const T &left, const T &right) const {
+    return less(left, right);
+}
+
+template <typename T, typename Compare>
+size_t AdaptiveMergeSorter<T, Compare>::CountRunAndMakeAscending(size_t first, size_t last) {
+    auto next = first + 1;
+    if (next == last) {
+        return 1;
+    }
+
+    // Убывающая серия должна быть строго убывающей, иначе разворот нарушит устойчивость.
+    if (Less(array[next], array[first])) {
+        while (++next < last && Less(array[next], array[next - 1]));
+        std::reverse(array + first, array + next);
+    }
+    else {
+        while (++next < last && !Less(array[next], array[next - 1]));
+    }
+
+    return next - first;
+}
+
+template <typename T, typename Compare>
+void AdaptiveMergeSorter<T, Compare>::BinaryInsertionSort(size_t first, size_t last, size_t start) {
+    for (auto i = std::max(start, first + 1); i < last; ++i) {
+        T pivot = std::move(array[i]);
+
+        // Ищем позицию после всех элементов, не больших pivot.
+        size_t low = first, high = i;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (Less(pivot, array[mid])) {
+                high = mid;
+            }
+            else {
+                low = mid + 1;
+            }
+        }
+
+        std::move_backward(array + low, array + i, array + i + 1);
+        array[low] = std::move(pivot);
+    }
+}
+
+// Возвращает количество элементов упорядоченного items, которые должны стоять
+// перед key: строго меньших key или, если countEqual, не больших key.
+// Поиск экспоненциальный - от начала или от конца массива.
+template <typename T, typename Compare>
+template <bool countEqual>
+size_t AdaptiveMergeSorter<T, Compare>::Gallop(const T &key, const T *items, size_t numItems, bool fromEnd) const {
+    auto precedes = [&](size_t index) {
+        return countEqual ? !Less(key, items[index]) : Less(items[index], key);
+    };
+
+    size_t low = 0, high = 0;
+    if (!fromEnd) {
+        if (!numItems || !precedes(0)) {
+            return 0;
+        }
+
+        size_t lastOffset = 0, offset = 1;
+        while (offset < numItems && precedes(offset)) {
+            lastOffset = offset;
+            offset = (offset << 1) + 1;
+        }
+        low = lastOffset + 1;
+        high = std::min(offset, numItems);
+    }
+    else {
+        if (!numItems || precedes(numItems - 1)) {
+            return numItems;
+        }
+
+        size_t lastOffset = 0, offset = 1;
+        while (offset < numItems && !precedes(numItems - 1 - offset)) {
+            lastOffset = offset;
+            offset = (offset << 1) + 1;
+        }
+        low = offset < numItems ? numItems - offset : 0;
+        high = numItems - 1 - lastOffset;
+    }
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (precedes(mid)) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+// Поддерживает инварианты стека серий: len[i - 2] > len[i - 1] + len[i] и len[i - 1] > len[i].
+template <typename T, typename Compare>
+void AdaptiveMergeSorter<T, Compare>::MergeCollapse() {
+    while (runs.size() > 1) {
+        auto n = runs.size() - 2;
+        if ((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length) ||
+            (n > 1 && runs[n - 2].length <= runs[n - 1].length + runs[n].length)) {
+            if (runs[n - 1].length < runs[n + 1].length) {
+                --n;
+            }
+        }
+        else if (runs[n].length > runs[n + 1].length) {
+            break;
+        }
+        MergeAt(n);
+    }
+}
+
+template <typename T, typename Compare>
+void AdaptiveMergeSorter<T, Compare>::MergeForceCollapse() {
+    while (runs.size() > 1) {
+        auto n = runs.size() - 2;
+        if (n > 0 && runs[n - 1].length < runs[n + 1].length) {
+            --n;
+        }
+        MergeAt(n);
+    }
+}
+
+template <typename T, typename Compare>
+void AdaptiveMergeSorter<T, Compare>::MergeAt(size_t index) {
+    auto first = runs[index].first;
+    auto firstLength = runs[index].length;
+    const auto second = runs[index + 1].first;
+    auto secondLength = runs[index + 1].length;
+    assert(first + firstLength == second);
+
+    runs[index].length += secondLength;
+    runs.erase(runs.begin() + index + 1);
+
+    // Начало первой серии, не большее second[0], уже на месте.
+    const auto skip = Gallop<true>(array[second], array + first, firstLength, false);
+    first += skip;
+    firstLength -= skip;
+    if (!firstLength) {
+        return;
+    }
+
+    // Хвост второй серии, не меньший последнего элемента первой, тоже на месте.
+    secondLength = Gallop<false>(array[second - 1], array + second, secondLength, true);
+    if (!secondLength) {
+        return;
+    }
+
+    if (firstLength <= secondLength) {
+        MergeLow(first, firstLength, second, secondLength);
+    }
+    else {
+        MergeHigh(first, firstLength, second, secondLength);
+    }
+}
+
+// Слияние с копированием первой (короткой) серии во временный буфер, слева направо.
+template <typename T, typename Compare>
+void AdaptiveMergeSorter<T, Compare>::MergeLow(size_t first, size_t firstLength, size_t second, size_t secondLength) {
+    if (temp.size() < firstLength) {
+        temp.resize(firstLength);
+    }
+    std::move(array + first, array + first + firstLength, temp.begin());
+
+    const T *left = temp.data();
+    size_t i = 0, j = second, target = first;
+    const auto secondLast = second + secondLength;
+
+    while (i < firstLength && j < secondLast) {
+        size_t count1 = 0, count2 = 0;
+
+        while (i < firstLength && j < secondLast) {
+            if (Less(array[j], left[i])) {
+                array[target++] = std::move(array[j++]);
+                count1 = 0;
+                if (++count2 >= minGallop) {
+                    break;
+                }
+            }
+            else {
+                array[target++] = std::move(temp[i++]);
+                count2 = 0;
+                if (++count1 >= minGallop) {
+                    break;
+                }
+            }
+        }
+
+        // Одна из серий "побеждает" - переходим в режим галопа.
+        while (i < firstLength && j < secondLast) {
+            count1 = Gallop<true>(array[j], left + i, firstLength - i, false);
+            std::move(temp.begin() + i, temp.begin() + i + count1, array + target);
+            i += count1, target += count1;
+            if (i == firstLength) {
+                break;
+            }
+
+            array[target++] = std::move(array[j++]);
+            if (j == secondLast) {
+                break;
+            }
+
+            count2 = Gallop<false>(left[i], array + j, secondLast - j, false);
+            std::move(array + j, array + j + count2, array + target);
+            j += count2, target += count2;
+            if (j == secondLast) {
+                break;
+            }
+
+            array[target++] = std::move(temp[i++]);
+
+            if (minGallop > 1) {
+                --minGallop;
+            }
+            if (count1 < MIN_GALLOP && count2 < MIN_GALLOP) {
+                break;
+            }
+        }
+        minGallop += 2;
+    }
+
+    std::move(temp.begin() + i, temp.begin() + firstLength, array + target);
+}
+
+// Слияние с копированием второй (короткой) серии во временный буфер, справа налево.
+template <typename T, typename Compare>
+void AdaptiveMergeSorter<T, Compare>::MergeHigh(size_t first, size_t firstLength, size_t second, size_t secondLength) {
+    if (temp.size() < secondLength) {
+        temp.resize(secondLength);
+    }
+    std::move(array + second, array + second + secondLength, temp.begin());
+
+    const T *right = temp.data();
+    size_t i = first + firstLength, j = secondLength, target = second + secondLength;
+
+    while (i > first && j > 0) {
+        size_t count1 = 0, count2 = 0;
+
+        while (i > first && j > 0) {
+            if (Less(right[j - 1], array[i - 1])) {
+                array[--target] = std::move(array[--i]);
+                count2 = 0;
+                if (++count1 >= minGallop) {
+                    break;
+                }
+            }
+            else {
+                array[--target] = std::move(temp[--j]);
+                count1 = 0;
+                if (++count2 >= minGallop) {
+                    break;
+                }
+            }
+        }
+
+        while (i > first && j > 0) {
+            count1 = (i - first) - Gallop<true>(right[j - 1], array + first, i - first, true);
+            std::move_backward(array + i - count1, array + i, array + target);
+            i -= count1, target -= count1;
+            if (i == first) {
+                break;
+            }
+
+            array[--target] = std::move(temp[--j]);
+            if (j == 0) {
+                break;
+            }
+
+            count2 = j - Gallop<false>(array[i - 1], right, j, true);
+            std::move(temp.begin() + j - count2, temp.begin() + j, array + target - count2);
+            j -= count2, target -= count2;
+            if (j == 0) {
+                break;
+            }
+
+            array[--target] = std::move(array[--i]);
+
+            if (minGallop > 1) {
+                --minGallop;
+            }
+            if (count1 < MIN_GALLOP && count2 < MIN_GALLOP) {
+                break;
+            }
+        }
+        minGallop += 2;
+    }
+
+    std::move(temp.begin(), temp.begin() + j, array + first);
+}
+
+template <typename T, typename Compare>
+size_t AdaptiveMergeSorter<T, Compare>::ComputeMinRun(size_t length) {
+    size_t remainder = 0;
+    while (length >= MIN_MERGE_RUN_LENGTH) {
+        remainder |= length & 1;
+        length >>= 1;
+    }
+    return length + remainder;
+}
+
+template <typename T, typename Compare>
+void adaptive_merge_sort(T *array, size_t arrayLength, Compare less) {
+    ASSERT_LESS_PREDICATE(T, Compare);
+    AdaptiveMergeSorter<T, Compare>(array, arrayLength, less).Sort();
+}
+
+template <typename T>
+void adaptive_merge_sort(T *array, size_t arrayLength, int (*compare_f)(const T &left, const T &right)) {
+    adaptive_merge_sort(array, arrayLength, ThreeWayLess<T>(compare_f));
+}
+
+// Возвращает количество элементов first среди первых diagonal элементов
+// результата устойчивого слияния first и second (merge path).
+template <typename T, typename Compare>
+size_t merge_path_split(const T *first, size_t firstLength, const T *second, size_t secondLength,
+        size_t diagonal, Compare less) {
+    assert(diagonal <= firstLength + secondLength);
+
+    size_t low = diagonal > secondLength ? diagonal - secondLength : 0;
+    size_t high = diagonal < firstLength ? diagonal : firstLength;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (less(second[diagonal - mid - 1], first[mid])) {
+            high = mid;
+        }
+        else {
+            low = mid + 1;
+        }
+    }
+
+    return low;
+}
+
+// Сливает в result часть [firstDiagonal, lastDiagonal) результата слияния first и second.
+template <typename T, typename Compare>
+void merge_range(T *result, T *first, size_t firstLength, T *second, size_t secondLength,
+        size_t firstDiagonal, size_t lastDiagonal, Compare less) {
+    if (firstDiagonal >= lastDiagonal) {
+        return;
+    }
+
+    auto i = merge_path_split(first, firstLength, second, secondLength, firstDiagonal, less);
+    auto j = firstDiagonal - i;
+    auto lastI = merge_path_split(first, firstLength, second, secondLength, lastDiagonal, less);
+    auto lastJ = lastDiagonal - lastI;
+
+    merge(result + firstDiagonal, first + i, lastI - i, second + j, lastJ - j, less);
+}
+
+// Задачи собираются независимо, поэтому те же run_in_parallel и default_num_threads
+// повторены в task06/parallel_partition.hpp и task07/radix_sort.hpp. Копии одинаковы
+// и закрыты общим макросом: бенчмарк подключает и sort.h, и radix_sort.h.
+#ifndef RUN_IN_PARALLEL_DEFINED
+#define RUN_IN_PARALLEL_DEFINED
+
+template <typename F>
+void run_in_parallel(size_t numThreads, F &&task) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (size_t t = 1; t < numThreads; ++t) {
+        threads.emplace_back(task, t);
+    }
+    task(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+inline size_t default_num_threads() {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+#endif //RUN_IN_PARALLEL_DEFINED
+
+template <typename T, typename Compare = default_less<T>>
+void parallel_merge_sort(T *array, size_t arrayLength, Compare less = Compare(), size_t numThreads = 0) {
+    ASSERT_LESS_PREDICATE(T, Compare);
+    if (!numThreads) {
+        numThreads = default_num_threads();
+    }
+    numThreads = std::min(numThreads, arrayLength / PARALLEL_MERGE_SORT_MIN_LENGTH);
+    if (numThreads <= 1) {
+        adaptive_merge_sort(array, arrayLength, less);
+        return;
+    }
+
+    // Границы отсортированных серий: серия r занимает [bounds[r], bounds[r + 1]).
+    std::vector<size_t> bounds(numThreads + 1);
+    for (size_t t = 0; t <= numThreads; ++t) {
+        bounds[t] = arrayLength * t / numThreads;
+    }
+
+    run_in_parallel(numThreads, [&](size_t t) {
+        adaptive_merge_sort(array + bounds[t], bounds[t + 1] - bounds[t], less);
+    });
+
+    auto *temp = new T[arrayLength];
+    T *source = array;
+    T *target = temp;
+
+    while (bounds.size() > 2) {
+        // Каждый поток получает равную долю выходного массива уровня,
+        // которая может захватывать несколько пар серий.
+        run_in_parallel(numThreads, [&](size_t t) {
+            const size_t outFirst = arrayLength * t / numThreads;
+            const size_t outLast = arrayLength * (t + 1) / numThreads;
+
+            for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+                const size_t pairFirst = bounds[r];
+                const size_t middle = bounds[r + 1];
+                const size_t pairLast = r + 2 < bounds.size() ? bounds[r + 2] : middle;
+                if (pairLast <= outFirst || pairFirst >= outLast) {
+                    continue;
+                }
+
+                const size_t firstDiagonal = std::max(outFirst, pairFirst) - pairFirst;
+                const size_t lastDiagonal = std::min(outLast, pairLast) - pairFirst;
+                merge_range(target + pairFirst, source + pairFirst, middle - pairFirst,
+                            source + middle, pairLast - middle, firstDiagonal, lastDiagonal, less);
+            }
+        });
+
+        std::vector<size_t> mergedBounds;
+        for (size_t r = 0; r < bounds.size(); r += 2) {
+            mergedBounds.push_back(bounds[r]);
+        }
+        if (mergedBounds.back() != arrayLength) {
+            mergedBounds.push_back(arrayLength);
+        }
+        bounds = std::move(mergedBounds);
+
+        std::swap(source, target);
+    }
+
+    if (source != array) {
+        memcpy(array, source, sizeof(T) * arrayLength);
+    }
+    delete[] temp;
+}
+
+template <typename T>
+void parallel_merge_sort(T *array, size_t arrayLength, int (*compare_f)(const T &left, const T &right),
+        size_t numThreads = 0) {
+    parallel_merge_sort(array, arrayLength, ThreeWayLess<T>(compare_f), numThreads);
+}
+
+// Для целых ключей с естественным порядком исчерпанный источник слияния
+// получает голову numeric_limits<T>::max(), и проверка исчерпания не нужна.
+template <typename T, typename Compare>
+struct has_merge_sentinel : std::integral_constant<bool,
+        std::is_integral<T>::value && std::is_same<Compare, default_less<T>>::value> {
+};
+
+// Дерево проигравших для k-путевого слияния: на каждый выходной элемент
+// приходится около log k сравнений. Источник i читается функцией readNext(i, item),
+// которая возвращает false, когда источник исчерпан.
+// Узлы хранят только номера источников, а сравниваются текущие головы источников.
+template <typename T, typename Reader, typename Compare = default_less<T>>
+class LoserTree {
+    public:
+        LoserTree(size_t numSources, Reader readNext, Compare less = Compare());
+
+        bool Pop(T &item);
+        bool IsEmpty() const;
+
+    private:
+        Reader readNext;
+        Compare less;
+
+        size_t numSources = 0;
+        std::vector<T> heads;
+        // Ранг источника i - i, у исчерпанного - i + numSources: при равных
+        // головах побеждает меньший ранг, поэтому слияние устойчиво, а
+        // исчерпанный источник проигрывает всем.
+        std::vector<uint32_t> ranks;
+        // tree[0] - текущий победитель, tree[1..k) - проигравшие во внутренних узлах.
+        std::vector<uint32_t> tree;
+
+        void Advance(size_t source);
+        void Replay(uint32_t winner, std::true_type isIntegralKey);
+        void Replay(uint32_t winner, std::false_type isIntegralKey);
+        bool Beats(size_t first, size_t second) const;
+        bool Beats(const T &first, uint32_t firstRank, const T &second, uint32_t secondRank) const;
+};
+
+template <typename T, typename Reader, typename Compare>
+LoserTree<T, Reader, Compare>::LoserTree(size_t numSources, Reader readNext, Compare less) :
+        readNext(readNext), less(less), numSources(numSources), heads(numSources), ranks(numSources),
+        tree(std::max<size_t>(numSources, 1)) {
+    ASSERT_LESS_PREDICATE(T, Compare);
+    assert(numSources <= UINT32_MAX / 2);
+    for (size_t i = 0; i < numSources; ++i) {
+        ranks[i] = static_cast<uint32_t>(i);
+        Advance(i);
+    }
+    if (numSources <= 1) {
+        return;
+    }
+
+    // Лист i находится в позиции numSources + i неявного дерева.
+    std::vector<uint32_t> winners(numSources);
+    for (auto node = numSources - 1; node > 0; --node) {
+        const auto left = node << 1;
+        const auto right = left + 1;
+        const auto leftWinner = static_cast<uint32_t>(left >= numSources ? left - numSources : winners[left]);
+        const auto rightWinner = static_cast<uint32_t>(right >= numSources ? right - numSources : winners[right]);
+
+        const auto isRightWinner = Beats(rightWinner, leftWinner);
+        winners[node] = isRightWinner ? rightWinner : leftWinner;
+        tree[node] = isRightWinner ? leftWinner : rightWinner;
+    }
+    tree[0] = winners[1];
+}
+
+template <typename T, typename Reader, typename Compare>
+inline bool LoserTree<T, Reader, Compare>::Pop(T &item) {
+    if (IsEmpty()) {
+        return false;
+    }
+
+    auto winner = tree[0];
+    item = std::move(heads[winner]);
+    Advance(winner);
+
+    Replay(winner, std::is_integral<T>());
+
+    return true;
+}
+
+// Номера проигравших на пути к корню и их головы читаются независимо от
+// сравнений; победитель выбирается масками, а не переходами, которые на
+// случайных данных ошибались бы в половине случаев. Целый ключ победителя
+// держится в регистре, остальные - через указатель на голову.
+template <typename T, typename Reader, typename Compare>
+inline void LoserTree<T, Reader, Compare>::Replay(uint32_t winner, std::true_type) {
+    auto winnerHead = heads[winner];
+    auto winnerRank = ranks[winner];
+    for (auto node = (winner + numSources) >> 1; node > 0; node >>= 1) {
+        const auto loser = tree[node];
+        const auto loserRank = ranks[loser];
+        const auto loserHead = heads[loser];
+        const auto isLoserWinner = Beats(loserHead, loserRank, winnerHead, winnerRank);
+        const auto mask = uint32_t(0) - isLoserWinner;
+        tree[node] = loser ^ ((loser ^ winner) & mask);
+        winner ^= (winner ^ loser) & mask;
+        winnerHead ^= (winnerHead ^ loserHead) & (T(0) - T(isLoserWinner));
+        winnerRank ^= (winnerRank ^ loserRank) & mask;
+    }
+    tree[0] = winner;
+}
+
+template <typename T, typename Reader, typename Compare>
+inline void LoserTree<T, Reader, Compare>::Replay(uint32_t winner, std::false_type) {
+    auto winnerHead = reinterpret_cast<uintptr_t>(&heads[winner]);
+    auto winnerRank = ranks[winner];
+    for (auto node = (winner + numSources) >> 1; node > 0; node >>= 1) {
+        const auto loser = tree[node];
+        const auto loserRank = ranks[loser];
+        const auto loserHead = reinterpret_cast<uintptr_t>(&heads[loser]);
+        const auto isLoserWinner = Beats(*reinterpret_cast<const T*>(loserHead), loserRank,
+                                         *reinterpret_cast<const T*>(winnerHead), winnerRank);
+        const auto mask = uint32_t(0) - isLoserWinner;
+        tree[node] = loser ^ ((loser ^ winner) & mask);
+        winner ^= (winner ^ loser) & mask;
+        winnerHead ^= (winnerHead ^ loserHead) & (uintptr_t(0) - isLoserWinner);
+        winnerRank ^= (winnerRank ^ loserRank) & mask;
+    }
+    tree[0] = winner;
+}
+
+template <typename T, typename Reader, typename Compare>
+bool LoserTree<T, Reader, Compare>::IsEmpty() const {
+    return !numSources || ranks[tree[0]] >= numSources;
+}
+
+template <typename T, typename Reader, typename Compare>
+inline void LoserTree<T, Reader, Compare>::Advance(size_t source) {
+    if (!readNext(source, heads[source])) {
+        ranks[source] = static_cast<uint32_t>(source + numSources);
+        if (has_merge_sentinel<T, Compare>::value) {
+            heads[source] = std::numeric_limits<T>::max();
+        }
+    }
+}
+
+template <typename T, typename Reader, typename Compare>
+inline bool LoserTree<T, Reader, Compare>::Beats(size_t first, size_t second) const {
+    return Beats(heads[first], ranks[first], heads[second], ranks[second]);
+}
+
+template <typename T, typename Reader, typename Compare>
+inline bool LoserTree<T, Reader, Compare>::Beats(const T &first, uint32_t firstRank,
+                                                 const T &second, uint32_t secondRank) const {
+    if (!has_merge_sentinel<T, Compare>::value && std::max(firstRank, secondRank) >= numSources) {
+        return firstRank < secondRank;
+    }
+    return less(first, second) | (!less(second, first) & (firstRank < secondRank));
+}
+
+template <typename T, typename Reader, typename Output, typename Compare = default_less<T>>
+void kway_merge_streams(size_t numSources, Reader readNext, Output output, Compare less = Compare()) {
+    LoserTree<T, Reader, Compare> tree(numSources, readNext, less);
+
+    T item{};
+    while (tree.Pop(item)) {
+        output(item);
+    }
+}
+
+// Сливает numRuns упорядоченных массивов runs[i] длины runLengths[i] в result.
+template <typename T, typename Compare = default_less<T>>
+void kway_merge(const T *const *runs, const size_t *runLengths, size_t numRuns, T *result,
+        Compare less = Compare()) {
+    assert((runs && runLengths) || !numRuns);
+
+    // Текущая позиция и конец каждой серии рядом в памяти.
+    std::vector<std::pair<const T*, const T*>> cursors(numRuns);
+    for (size_t r = 0; r < numRuns; ++r) {
+        cursors[r] = {runs[r], runs[r] + runLengths[r]};
+    }
+    auto readNext = [&cursors](size_t run, T &item) {
+        auto &cursor = cursors[run];
+        if (cursor.first == cursor.second) {
+            return false;
+        }
+        item = *cursor.first++;
+        return true;
+    };
+
+    kway_merge_streams<T>(numRuns, readNext, [&result](const T &item) {
+        *result++ = item;
+    }, less);
+}
+
 #endif //SORT_H
@@ -0,0 +1,519 @@
+/* Замеры производительности выбора k-й порядковой статистики.
+ * Запуск: task06_benchmark [n]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <functional>
+
+#include "partition.h"
+#include "quantile_sketch.h"
+#include "top_k.h"
+
+#define DEFAULT_BENCHMARK_LENGTH 10000000
+#define LOW_CARDINALITY_MAX_LENGTH (1 << 16)
+
+typedef std::vector<int> array_t;
+
+static size_t numComparisons = 0;
+
+int counting_compare(const int &left, const int &right) {
+    ++numComparisons;
+    return default_compare(left, right);
+}
+
+template <typename F>
+double measure_seconds(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void print_result(const std::string &name, double seconds, double baseline) {
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3) << seconds << " s"
+              << std::setw(10) << std::setprecision(2) << baseline / seconds << "x";
+}
+
+array_t make_random_array(size_t n, int maxValue) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(0, maxValue);
+
+    array_t array(n);
+    for (auto &x : array) {
+        x = distribution(generator);
+    }
+    return array;
+}
+
+void fail(const std::string &message) {
+    std::cerr << "[" << message << "]" << std::endl;
+    std::exit(1);
+}
+
+static const struct {
+    const char *name;
+    SelectStrategy strategy;
+} STRATEGIES[] = {
+    {"random", SelectStrategy::RANDOM},
+    {"introselect", SelectStrategy::INTROSELECT},
+    {"floyd-rivest", SelectStrategy::FLOYD_RIVEST},
+    {"block", SelectStrategy::BLOCK},
+    {"three-way", SelectStrategy::THREE_WAY}
+};
+
+void benchmark_strategies(const array_t &input) {
+    const auto n = input.size();
+    const size_t positions[] = {0, n / 100, n / 2, n - 1 - n / 100, n - 1};
+
+    auto sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (auto k : positions) {
+        std::cout << "--- select_k_stat, n = " << n << ", k = " << k << " ---" << std::endl;
+
+        double baseline = 0;
+        for (auto &entry : STRATEGIES) {
+            auto array = input;
+            numComparisons = 0;
+            int result = 0;
+            const auto seconds = measure_seconds([&]() {
+                result = select_k_stat(array.data(), n, k, entry.strategy, counting_compare);
+            });
+            if (result != sorted[k]) {
+                fail("wrong k-th statistic");
+            }
+            if (!baseline) {
+                baseline = seconds;
+            }
+            print_result(entry.name, seconds, baseline);
+            std::cout << std::setw(10) << std::setprecision(2)
+                      << static_cast<double>(numComparisons) / n << " cmp/n" << std::endl;
+        }
+    }
+}
+
+void benchmark_quantiles(const array_t &input) {
+    const auto n = input.size();
+    const size_t ks[] = {n / 2, n * 9 / 10, n * 99 / 100, n * 999 / 1000};
+    const size_t numKs = sizeof(ks) / sizeof(ks[0]);
+
+    std::cout << "--- p50/p90/p99/p99.9, n = " << n << " ---" << std::endl;
+
+    auto sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto array = input;
+    int results[numKs];
+    numComparisons = 0;
+    const auto baseline = measure_seconds([&]() {
+        for (size_t i = 0; i < numKs; ++i) {
+            results[i] = find_k_stat(array.data(), n, ks[i], counting_compare);
+        }
+    });
+    for (size_t i = 0; i < numKs; ++i) {
+        if (results[i] != sorted[ks[i]]) {
+            fail("wrong quantile");
+        }
+    }
+    print_result("find_k_stat x4", baseline, baseline);
+    std::cout << std::setw(10) << std::setprecision(2)
+              << static_cast<double>(numComparisons) / n << " cmp/n" << std::endl;
+
+    array = input;
+    numComparisons = 0;
+    const auto seconds = measure_seconds([&]() {
+        find_k_stats(array.data(), n, ks, numKs, results, counting_compare);
+    });
+    for (size_t i = 0; i < numKs; ++i) {
+        if (results[i] != sorted[ks[i]]) {
+            fail("wrong quantile");
+        }
+    }
+    print_result("find_k_stats", seconds, baseline);
+    std::cout << std::setw(10) << std::setprecision(2)
+              << static_cast<double>(numComparisons) / n << " cmp/n" << std::endl;
+}
+
+void benchmark_parallel_select(const array_t &input) {
+    const auto n = input.size();
+    const auto k = n / 2;
+
+    std::cout << "--- parallel_select, n = " << n << ", k = " << k << " ---" << std::endl;
+
+    auto sorted = input;
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+
+    auto array = input;
+    int result = 0;
+    const auto baseline = measure_seconds([&]() {
+        result = introselect(array.data(), n, k);
+    });
+    if (result != sorted[k]) {
+        fail("wrong k-th statistic");
+    }
+    print_result("introselect", baseline, baseline);
+    std::cout << std::endl;
+
+    const auto maxThreads = default_num_threads();
+    for (size_t numThreads = 1; numThreads <= maxThreads; numThreads <<= 1) {
+        array = input;
+        const auto seconds = measure_seconds([&]() {
+            result = parallel_select(array.data(), n, k, default_compare, numThreads);
+        });
+        if (result != sorted[k]) {
+            fail("wrong k-th statistic");
+        }
+        print_result("parallel_select, threads = " + std::to_string(numThreads), seconds, baseline);
+        std::cout << std::endl;
+    }
+}
+
+void benchmark_quantile_sketch(const array_t &input) {
+    const auto n = input.size();
+    const double quantiles[] = {0.001, 0.01, 0.5, 0.9, 0.99, 0.999};
+
+    std::cout << "--- quantile sketch, n = " << n << ", k = " << QUANTILE_SKETCH_DEFAULT_K << " ---" << std::endl;
+
+    auto sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    // Наибольшее отклонение ранга ответа от запрошенного по всем квантилям.
+    // copies - сколько раз каждый элемент входа попал в скетч.
+    auto max_rank_error = [&](const QuantileSketch<int> &sketch, size_t copies = 1) {
+        const auto total = n * copies;
+        double maxError = 0;
+        for (auto q : quantiles) {
+            const auto rank = static_cast<size_t>(q * total);
+            const auto value = sketch.GetKthValue(rank);
+            const auto lower = copies * static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin());
+            const auto upper = copies * static_cast<size_t>(std::upper_bound(sorted.begin(), sorted.end(), value) - sorted.begin());
+            const auto error = rank < lower ? lower - rank : (rank >= upper ? rank - upper + 1 : 0);
+            maxError = std::max(maxError, static_cast<double>(error) / total);
+        }
+        return maxError;
+    };
+    auto print_sketch = [&](const std::string &name, double seconds, double baseline, const QuantileSketch<int> &sketch) {
+        print_result(name, seconds, baseline);
+        std::cout << std::setw(10) << sketch.GetNumRetained() << " items"
+                  << std::setw(10) << std::setprecision(4) << max_rank_error(sketch) << " max error"
+                  << " (bound " << sketch.GetRankError() << ")" << std::endl;
+    };
+
+    auto array = input;
+    int exact = 0;
+    const auto baseline = measure_seconds([&]() {
+        exact = introselect(array.data(), n, n / 2);
+    });
+    if (exact != sorted[n / 2]) {
+        fail("wrong k-th statistic");
+    }
+    print_result("introselect, in memory", baseline, baseline);
+    std::cout << std::endl;
+
+    QuantileSketch<int> sketch;
+    const auto insertSeconds = measure_seconds([&]() {
+        for (auto x : input) {
+            sketch.Insert(x);
+        }
+    });
+    print_sketch("sketch, insert", insertSeconds, baseline, sketch);
+
+    // Слияние с самим собой равносильно повторной вставке всего входа.
+    auto doubled = sketch;
+    doubled.Merge(doubled);
+    if (doubled.GetNumItems() != 2 * sketch.GetNumItems()) {
+        fail("wrong number of items after self-merge");
+    }
+    if (max_rank_error(doubled, 2) > doubled.GetRankError()) {
+        fail("rank error bound violated after self-merge");
+    }
+
+    const auto numThreads = default_num_threads();
+    std::vector<QuantileSketch<int>> parts(numThreads);
+    const auto mergeSeconds = measure_seconds([&]() {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (size_t i = t * n / numThreads; i < (t + 1) * n / numThreads; ++i) {
+                    parts[t].Insert(input[i]);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        for (size_t t = 1; t < numThreads; ++t) {
+            parts[0].Merge(parts[t]);
+        }
+    });
+    print_sketch("sketch + merge, threads = " + std::to_string(numThreads), mergeSeconds, baseline, parts[0]);
+
+    for (auto q : quantiles) {
+        const auto k = static_cast<size_t>(q * n);
+        int result = 0;
+        const auto seconds = measure_seconds([&]() {
+            result = refine_k_stat(sketch, k, [&](const std::function<void(const int &)> &visit) {
+                for (auto x : input) {
+                    visit(x);
+                }
+            });
+        });
+        if (result != sorted[k]) {
+            fail("wrong refined k-th statistic");
+        }
+        print_result("refine_k_stat, q = " + std::to_string(q).substr(0, 5), seconds, baseline);
+        std::cout << std::endl;
+    }
+}
+
+void benchmark_top_k(const array_t &input) {
+    const auto n = input.size();
+    const size_t ks[] = {10, 1000, n / 100, n / 10};
+
+    auto sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (auto k : ks) {
+        if (k > n) {
+            continue;
+        }
+        std::cout << "--- top_k, n = " << n << ", k = " << k << " ---" << std::endl;
+
+        auto check = [&](const int *result) {
+            if (!std::equal(result, result + k, sorted.begin())) {
+                fail("wrong top-k");
+            }
+        };
+
+        auto array = input;
+        const auto baseline = measure_seconds([&]() {
+            std::sort(array.begin(), array.end());
+        });
+        check(array.data());
+        print_result("full sort (std::sort)", baseline, baseline);
+        std::cout << std::endl;
+
+        array = input;
+        auto seconds = measure_seconds([&]() {
+            partial_sort(array.data(), n, k);
+        });
+        check(array.data());
+        print_result("partial_sort", seconds, baseline);
+        std::cout << std::endl;
+
+        array = input;
+        seconds = measure_seconds([&]() {
+            std::partial_sort(array.begin(), array.begin() + k, array.end());
+        });
+        check(array.data());
+        print_result("std::partial_sort", seconds, baseline);
+        std::cout << std::endl;
+
+        array_t result(k);
+        seconds = measure_seconds([&]() {
+            TopKHeap<int> heap(k);
+            for (auto x : input) {
+                heap.Insert(x);
+            }
+            heap.ExtractSorted(result.data());
+        });
+        check(result.data());
+        print_result("TopKHeap", seconds, baseline);
+        std::cout << std::endl;
+
+        seconds = measure_seconds([&]() {
+            top_k(input.data(), n, k, result.data());
+        });
+        check(result.data());
+        print_result("top_k", seconds, baseline);
+        std::cout << std::endl;
+    }
+}
+
+// Двухчастное разбиение на таких данных квадратично, поэтому длина ограничена.
+void benchmark_low_cardinality(size_t n) {
+    n = std::min<size_t>(n, LOW_CARDINALITY_MAX_LENGTH);
+    const auto k = n / 2;
+    const int numDistinct[] = {2, 16, 1024};
+
+    for (auto distinct : numDistinct) {
+        const auto input = make_random_array(n, distinct - 1);
+        auto sorted = input;
+        std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+
+        std::cout << "--- select_k_stat, " << distinct << " distinct values, n = " << n
+                  << ", k = " << k << " ---" << std::endl;
+
+        double baseline = 0;
+        for (auto &entry : STRATEGIES) {
+            auto array = input;
+            numComparisons = 0;
+            int result = 0;
+            const auto seconds = measure_seconds([&]() {
+                result = select_k_stat(array.data(), n, k, entry.strategy, counting_compare);
+            });
+            if (result != sorted[k]) {
+                fail("wrong k-th statistic");
+            }
+            if (!baseline) {
+                baseline = seconds;
+            }
+            print_result(entry.name, seconds, baseline);
+            std::cout << std::setw(10) << std::setprecision(2)
+                      << static_cast<double>(numComparisons) / n << " cmp/n" << std::endl;
+        }
+    }
+}
+
+// Тот же порядок, что у default_compare, но без векторного пути разбиения.
+template <typename T>
+int scalar_compare(const T &left, const T &right) {
+    return default_compare(left, right);
+}
+
+template <typename T>
+struct scalar_less {
+    bool operator()(const T &left, const T &right) const {
+        return left < right;
+    }
+};
+
+// Скалярное ядро со встроенным сравнением.
+template <typename T>
+size_t block_partition_around_less(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+        int (*)(const T &, const T &)) {
+    return block_partition_around(array, firstIndex, lastIndex, pivotIndex, scalar_less<T>());
+}
+
+// Векторное разбиение только на AVX2, даже если процессор умеет AVX-512.
+// AVX2-путь есть лишь для int32_t.
+template <typename T>
+struct avx2_partition {
+    static const bool AVAILABLE = false;
+
+    static size_t Around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+            int (*compFunc)(const T &, const T &)) {
+        return block_partition_around_less(array, firstIndex, lastIndex, pivotIndex, compFunc);
+    }
+};
+
+#if SIMD_PARTITION_AVAILABLE
+template <>
+struct avx2_partition<int32_t> {
+    static const bool AVAILABLE = true;
+
+    static size_t Around(int32_t *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+            int (*compFunc)(const int32_t &, const int32_t &)) {
+        if (lastIndex - firstIndex < 2 * avx2_int32_traits::WIDTH || !avx2_partition_supported()) {
+            return block_partition_around_less(array, firstIndex, lastIndex, pivotIndex, compFunc);
+        }
+        std::swap(array[firstIndex], array[pivotIndex]);
+        const auto boundary = avx2_partition_range<avx2_int32_traits>(array, firstIndex + 1, lastIndex + 1,
+                array[firstIndex]);
+        std::swap(array[firstIndex], array[boundary - 1]);
+        return boundary - 1;
+    }
+};
+#endif
+
+template <typename T>
+void benchmark_block_partition(const array_t &input, const std::string &typeName) {
+    typedef std::vector<T> typed_array_t;
+    typedef size_t (*partition_func_t)(T *, size_t, size_t, size_t, int (*)(const T &, const T &));
+
+    const auto n = input.size();
+    const auto k = n / 2;
+    const typed_array_t typedInput(input.begin(), input.end());
+
+    static const struct {
+        const char *name;
+        partition_func_t partitionFunc;
+        bool isVectorized;
+        bool isAvx2;
+    } PARTITIONS[] = {
+        {"partition_around", partition_around<T>, false, false},
+        {"block_partition_around", block_partition_around<T>, false, false},
+        {"block_partition_around, less", block_partition_around_less<T>, false, false},
+        {"block_partition_around+avx2", avx2_partition<T>::Around, false, true},
+        {"block_partition_around+simd", block_partition_around<T>, true, false}
+    };
+
+    std::cout << "--- partition, " << typeName << ", n = " << n << " ---" << std::endl;
+
+    double baseline = 0;
+    for (auto &entry : PARTITIONS) {
+        if (entry.isAvx2 && !avx2_partition<T>::AVAILABLE) {
+            continue;
+        }
+        auto array = typedInput;
+        auto compFunc = entry.isVectorized ? default_compare<T> : scalar_compare<T>;
+        size_t p = 0;
+        const auto seconds = measure_seconds([&]() {
+            p = entry.partitionFunc(array.data(), 0, n - 1, k, compFunc);
+        });
+        for (size_t i = 0; i < n; ++i) {
+            if ((i < p && array[i] > array[p]) || (i > p && array[i] <= array[p])) {
+                fail("wrong partition");
+            }
+        }
+        if (!baseline) {
+            baseline = seconds;
+        }
+        print_result(entry.name, seconds, baseline);
+        std::cout << std::setw(10) << std::setprecision(1) << n / seconds / 1e6 << " M/s" << std::endl;
+    }
+
+    std::cout << "--- introselect, " << typeName << ", n = " << n << ", k = " << k << " ---" << std::endl;
+
+    auto sorted = typedInput;
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+
+    baseline = 0;
+    for (auto &entry : PARTITIONS) {
+        if (entry.isAvx2 && !avx2_partition<T>::AVAILABLE) {
+            continue;
+        }
+        auto array = typedInput;
+        auto compFunc = entry.isVectorized ? default_compare<T> : scalar_compare<T>;
+        T result = 0;
+        const auto seconds = measure_seconds([&]() {
+            result = introselect(array.data(), n, k, compFunc, entry.partitionFunc);
+        });
+        if (result != sorted[k]) {
+            fail("wrong k-th statistic");
+        }
+        if (!baseline) {
+            baseline = seconds;
+        }
+        print_result(std::string("with ") + entry.name, seconds, baseline);
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_BENCHMARK_LENGTH;
+    if (!n) {
+        fail("n should be greater than 0");
+    }
+
+    const auto input = make_random_array(n, 1000000000);
+    benchmark_strategies(input);
+    benchmark_low_cardinality(n);
+    benchmark_quantiles(input);
+    benchmark_parallel_select(input);
+    benchmark_quantile_sketch(input);
+    benchmark_top_k(input);
+    benchmark_block_partition<int32_t>(input, "int32_t");
+    benchmark_block_partition<int64_t>(input, "int64_t");
+
+    return 0;
+}
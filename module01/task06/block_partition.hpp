@@ -0,0 +1,394 @@
+#ifndef BLOCK_PARTITION_HPP
+#define BLOCK_PARTITION_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_PARTITION_AVAILABLE 1
+#include <immintrin.h>
+#define AVX512_PARTITION_TARGET __attribute__((target("avx512f")))
+#define AVX2_PARTITION_TARGET __attribute__((target("avx2")))
+#else
+#define SIMD_PARTITION_AVAILABLE 0
+#endif
+
+#define PARTITION_BLOCK_LENGTH 128
+
+template <typename T>
+struct default_less {
+    bool operator()(const T &left, const T &right) const {
+        return left < right;
+    }
+};
+
+// Адаптер для трёхзначных функций сравнения: ядра разбиения ниже принимают
+// предикат "меньше", который компилятор может встроить.
+template <typename T>
+class ThreeWayLess {
+    public:
+        explicit ThreeWayLess(compare_f(compFunc)) : compFunc(compFunc) {
+            assert(compFunc);
+        }
+
+        bool operator()(const T &left, const T &right) const {
+            return compFunc(left, right) < 0;
+        }
+
+    private:
+        compare_f(compFunc) = nullptr;
+};
+
+template <typename T>
+T &block_select(T *array, size_t n, size_t k, compare_f(compFunc)) {
+    return introselect(array, n, k, compFunc, block_partition_around<T>);
+}
+
+// Доразбиение [i, j) двумя итераторами; возвращает начало части больших элементов.
+template <typename T, typename Compare>
+size_t partition_tail(T *array, size_t i, size_t j, const T &pivot, Compare less) {
+    while (true) {
+        while (i < j && !less(pivot, array[i])) {
+            ++i;
+        }
+        while (i < j && less(pivot, array[j - 1])) {
+            --j;
+        }
+        if (i >= j) {
+            return i;
+        }
+        std::swap(array[i++], array[--j]);
+    }
+}
+
+// Разбиение [first, last) по блокам (BlockQuicksort): результаты сравнений
+// записываются в буферы смещений без ветвлений, затем элементы не на своих
+// местах меняются пачкой. Возвращает начало части больших элементов.
+template <typename T, typename Compare>
+size_t block_partition_range(T *array, size_t first, size_t last, const T &pivot, Compare less) {
+    uint8_t leftOffsets[PARTITION_BLOCK_LENGTH];
+    uint8_t rightOffsets[PARTITION_BLOCK_LENGTH];
+    size_t numLeft = 0, numRight = 0;
+    size_t leftStart = 0, rightStart = 0;
+
+    size_t left = first, right = last;
+    while (right - left >= 2 * PARTITION_BLOCK_LENGTH) {
+        if (!numLeft) {
+            leftStart = 0;
+            for (size_t i = 0; i < PARTITION_BLOCK_LENGTH; ++i) {
+                leftOffsets[numLeft] = static_cast<uint8_t>(i);
+                numLeft += less(pivot, array[left + i]);
+            }
+        }
+        if (!numRight) {
+            rightStart = 0;
+            for (size_t i = 0; i < PARTITION_BLOCK_LENGTH; ++i) {
+                rightOffsets[numRight] = static_cast<uint8_t>(i);
+                numRight += !less(pivot, array[right - 1 - i]);
+            }
+        }
+
+        const auto numSwaps = std::min(numLeft, numRight);
+        for (size_t i = 0; i < numSwaps; ++i) {
+            std::swap(array[left + leftOffsets[leftStart + i]], array[right - 1 - rightOffsets[rightStart + i]]);
+        }
+
+        numLeft -= numSwaps, leftStart += numSwaps;
+        numRight -= numSwaps, rightStart += numSwaps;
+        if (!numLeft) {
+            left += PARTITION_BLOCK_LENGTH;
+        }
+        if (!numRight) {
+            right -= PARTITION_BLOCK_LENGTH;
+        }
+    }
+
+    // Вне [left, right) все элементы уже на своих местах.
+    return partition_tail(array, left, right, pivot, less);
+}
+
+#if SIMD_PARTITION_AVAILABLE
+
+inline bool avx512_partition_supported() {
+    static const bool supported = __builtin_cpu_supports("avx512f");
+    return supported;
+}
+
+struct avx512_int32_traits {
+    typedef int32_t key_t;
+    static const size_t WIDTH = 16;
+
+    AVX512_PARTITION_TARGET static __m512i Set(key_t x) {
+        return _mm512_set1_epi32(x);
+    }
+    AVX512_PARTITION_TARGET static __m512i Load(const key_t *p) {
+        return _mm512_loadu_si512(p);
+    }
+    AVX512_PARTITION_TARGET static uint32_t Greater(__m512i v, __m512i pivot) {
+        return _mm512_cmpgt_epi32_mask(v, pivot);
+    }
+    AVX512_PARTITION_TARGET static void CompressStore(key_t *p, uint32_t mask, __m512i v) {
+        _mm512_mask_compressstoreu_epi32(p, static_cast<__mmask16>(mask), v);
+    }
+};
+
+struct avx512_int64_traits {
+    typedef int64_t key_t;
+    static const size_t WIDTH = 8;
+
+    AVX512_PARTITION_TARGET static __m512i Set(key_t x) {
+        return _mm512_set1_epi64(x);
+    }
+    AVX512_PARTITION_TARGET static __m512i Load(const key_t *p) {
+        return _mm512_loadu_si512(p);
+    }
+    AVX512_PARTITION_TARGET static uint32_t Greater(__m512i v, __m512i pivot) {
+        return _mm512_cmpgt_epi64_mask(v, pivot);
+    }
+    AVX512_PARTITION_TARGET static void CompressStore(key_t *p, uint32_t mask, __m512i v) {
+        _mm512_mask_compressstoreu_epi64(p, static_cast<__mmask8>(mask), v);
+    }
+};
+
+// Элементы не больше опорного упаковываются влево от leftWrite, большие - вправо до rightWrite.
+template <typename Traits>
+AVX512_PARTITION_TARGET inline void avx512_partition_store(typename Traits::key_t *array, __m512i v,
+        __m512i pivotVector, uint32_t validLanes, size_t &leftWrite, size_t &rightWrite) {
+    const auto greater = Traits::Greater(v, pivotVector) & validLanes;
+    const auto notGreater = ~greater & validLanes;
+    Traits::CompressStore(array + leftWrite, notGreater, v);
+    leftWrite += static_cast<size_t>(__builtin_popcount(notGreater));
+    rightWrite -= static_cast<size_t>(__builtin_popcount(greater));
+    Traits::CompressStore(array + rightWrite, greater, v);
+}
+
+// Векторное разбиение на месте: по вектору с каждого конца откладывается в регистры,
+// и освободившееся место принимает упакованные (compress-store) части следующих векторов.
+// Загрузка идёт с той стороны, где свободного места меньше, поэтому запись не
+// затирает непрочитанные элементы. Требует last - first >= 2 * WIDTH.
+template <typename Traits>
+AVX512_PARTITION_TARGET size_t avx512_partition_range(typename Traits::key_t *array, size_t first, size_t last,
+        typename Traits::key_t pivot) {
+    typedef typename Traits::key_t key_t;
+    const size_t width = Traits::WIDTH;
+    const uint32_t allLanes = (1u << width) - 1;
+    assert(last - first >= 2 * width);
+
+    const auto pivotVector = Traits::Set(pivot);
+
+    const auto savedLeft = Traits::Load(array + first);
+    const auto savedRight = Traits::Load(array + last - width);
+
+    size_t leftWrite = first, rightWrite = last;
+    size_t left = first + width, right = last - width;
+
+    while (right - left >= width) {
+        __m512i v;
+        if (left - leftWrite <= rightWrite - right) {
+            v = Traits::Load(array + left);
+            left += width;
+        }
+        else {
+            right -= width;
+            v = Traits::Load(array + right);
+        }
+        avx512_partition_store<Traits>(array, v, pivotVector, allLanes, leftWrite, rightWrite);
+    }
+
+    // Остаток короче вектора копируется, чтобы запись не затёрла его.
+    key_t tail[width] = {};
+    const auto tailLength = right - left;
+    memcpy(tail, array + left, tailLength * sizeof(key_t));
+    avx512_partition_store<Traits>(array, Traits::Load(tail), pivotVector, (1u << tailLength) - 1,
+            leftWrite, rightWrite);
+
+    avx512_partition_store<Traits>(array, savedLeft, pivotVector, allLanes, leftWrite, rightWrite);
+    avx512_partition_store<Traits>(array, savedRight, pivotVector, allLanes, leftWrite, rightWrite);
+
+    assert(leftWrite == rightWrite);
+    return leftWrite;
+}
+
+inline bool avx2_partition_supported() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// Перестановки полос для AVX2, где нет compress-store: по маске больших
+// элементов ключи не больше опорного ставятся в начало вектора.
+struct avx2_permutation_table {
+    uint32_t lanes[256][8];
+
+    avx2_permutation_table() {
+        for (uint32_t mask = 0; mask < 256; ++mask) {
+            size_t next = 0;
+            for (uint32_t isGreater = 0; isGreater < 2; ++isGreater) {
+                for (uint32_t i = 0; i < 8; ++i) {
+                    if (((mask >> i) & 1) == isGreater) {
+                        lanes[mask][next++] = i;
+                    }
+                }
+            }
+        }
+    }
+};
+
+struct avx2_int32_traits {
+    typedef int32_t key_t;
+    static const size_t WIDTH = 8;
+
+    AVX2_PARTITION_TARGET static __m256i Set(key_t x) {
+        return _mm256_set1_epi32(x);
+    }
+    AVX2_PARTITION_TARGET static __m256i Load(const key_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    AVX2_PARTITION_TARGET static void Store(key_t *p, __m256i v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+    }
+    AVX2_PARTITION_TARGET static uint32_t Greater(__m256i v, __m256i pivot) {
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, pivot))));
+    }
+    AVX2_PARTITION_TARGET static __m256i Permute(__m256i v, const uint32_t *lanes) {
+        return _mm256_permutevar8x32_epi32(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes)));
+    }
+};
+
+// Переставленный вектор записывается целиком у обоих концов свободного места:
+// слева остаются элементы не больше опорного, справа - большие.
+template <typename Traits>
+AVX2_PARTITION_TARGET inline void avx2_partition_store(typename Traits::key_t *array, __m256i v,
+        __m256i pivotVector, const avx2_permutation_table &table, size_t &leftWrite, size_t &rightWrite) {
+    const auto greater = Traits::Greater(v, pivotVector);
+    const auto numGreater = static_cast<size_t>(__builtin_popcount(greater));
+    v = Traits::Permute(v, table.lanes[greater]);
+    Traits::Store(array + leftWrite, v);
+    Traits::Store(array + rightWrite - Traits::WIDTH, v);
+    leftWrite += Traits::WIDTH - numGreater;
+    rightWrite -= numGreater;
+}
+
+// Та же схема, что у avx512_partition_range. Загрузка со стороны, где свободного
+// места меньше, оставляет с каждой стороны не меньше вектора свободного места,
+// поэтому лишние полосы полных записей попадают только на свободные места.
+// Остаток короче вектора раскладывается поэлементно. Требует last - first >= 2 * WIDTH.
+template <typename Traits>
+AVX2_PARTITION_TARGET size_t avx2_partition_range(typename Traits::key_t *array, size_t first, size_t last,
+        typename Traits::key_t pivot) {
+    typedef typename Traits::key_t key_t;
+    const size_t width = Traits::WIDTH;
+    static const avx2_permutation_table table;
+    assert(last - first >= 2 * width);
+
+    const auto pivotVector = Traits::Set(pivot);
+
+    const auto savedLeft = Traits::Load(array + first);
+    const auto savedRight = Traits::Load(array + last - width);
+
+    size_t leftWrite = first, rightWrite = last;
+    size_t left = first + width, right = last - width;
+
+    while (right - left >= width) {
+        __m256i v;
+        if (left - leftWrite <= rightWrite - right) {
+            v = Traits::Load(array + left);
+            left += width;
+        }
+        else {
+            right -= width;
+            v = Traits::Load(array + right);
+        }
+        avx2_partition_store<Traits>(array, v, pivotVector, table, leftWrite, rightWrite);
+    }
+
+    key_t tail[width];
+    const auto tailLength = right - left;
+    memcpy(tail, array + left, tailLength * sizeof(key_t));
+    for (size_t i = 0; i < tailLength; ++i) {
+        if (tail[i] > pivot) {
+            array[--rightWrite] = tail[i];
+        }
+        else {
+            array[leftWrite++] = tail[i];
+        }
+    }
+
+    avx2_partition_store<Traits>(array, savedLeft, pivotVector, table, leftWrite, rightWrite);
+    avx2_partition_store<Traits>(array, savedRight, pivotVector, table, leftWrite, rightWrite);
+
+    assert(leftWrite == rightWrite);
+    return leftWrite;
+}
+
+template <typename T, typename Compare>
+bool try_simd_partition_range(T *, size_t, size_t, const T &, Compare, size_t &) {
+    return false;
+}
+
+// Векторный путь верен только для естественного порядка.
+inline bool try_simd_partition_range(int32_t *array, size_t first, size_t last, const int32_t &pivot,
+        default_less<int32_t>, size_t &boundary) {
+    if (last - first >= 2 * avx512_int32_traits::WIDTH && avx512_partition_supported()) {
+        boundary = avx512_partition_range<avx512_int32_traits>(array, first, last, pivot);
+        return true;
+    }
+    if (last - first >= 2 * avx2_int32_traits::WIDTH && avx2_partition_supported()) {
+        boundary = avx2_partition_range<avx2_int32_traits>(array, first, last, pivot);
+        return true;
+    }
+    return false;
+}
+
+// Для int64_t в векторе AVX2 лишь четыре ключа, и такое разбиение медленнее
+// скалярного блочного, поэтому без AVX-512 используется block_partition_range.
+inline bool try_simd_partition_range(int64_t *array, size_t first, size_t last, const int64_t &pivot,
+        default_less<int64_t>, size_t &boundary) {
+    if (last - first >= 2 * avx512_int64_traits::WIDTH && avx512_partition_supported()) {
+        boundary = avx512_partition_range<avx512_int64_traits>(array, first, last, pivot);
+        return true;
+    }
+    return false;
+}
+
+#else
+
+template <typename T, typename Compare>
+bool try_simd_partition_range(T *, size_t, size_t, const T &, Compare, size_t &) {
+    return false;
+}
+
+#endif //SIMD_PARTITION_AVAILABLE
+
+// Контракт как у partition_around, но с предикатом "меньше". Для int32_t/int64_t
+// с default_less используется векторное разбиение (AVX-512, для int32_t ещё AVX2).
+template <typename T, typename Compare>
+size_t block_partition_around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex, Compare less) {
+    assert(array);
+    assert(firstIndex <= pivotIndex && pivotIndex <= lastIndex);
+
+    std::swap(array[firstIndex], array[pivotIndex]);
+    const T pivot = array[firstIndex];
+
+    size_t boundary = 0;
+    if (!try_simd_partition_range(array, firstIndex + 1, lastIndex + 1, pivot, less, boundary)) {
+        boundary = block_partition_range(array, firstIndex + 1, lastIndex + 1, pivot, less);
+    }
+
+    std::swap(array[firstIndex], array[boundary - 1]);
+    return boundary - 1;
+}
+
+// default_compare заменяется встраиваемым default_less, остальные функции
+// вызываются через адаптер.
+template <typename T>
+size_t block_partition_around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex, compare_f(compFunc)) {
+    assert(compFunc);
+    if (compFunc == &default_compare<T>) {
+        return block_partition_around(array, firstIndex, lastIndex, pivotIndex, default_less<T>());
+    }
+    return block_partition_around(array, firstIndex, lastIndex, pivotIndex, ThreeWayLess<T>(compFunc));
+}
+
+#endif //BLOCK_PARTITION_HPP
@@ -9,17 +9,31 @@
  */
 
 #include <iostream>
+#include <cstring>
+#include <stdexcept>
 #include "partition.h"
+#include "quantile_sketch.h"
 
 #define PRINT_ERROR(err_msg) \
     std::cerr << (err_msg);
 
-int main() {
+typedef struct {
+    SelectStrategy strategy = SelectStrategy::RANDOM;
+    // Приближённый ответ по эскизу KLL без хранения массива.
+    bool isApproximate = false;
+} options_t;
+
+// Разбор аргументов --strategy=<random|introselect|floyd-rivest|parallel|block|three-way> и --approximate.
+options_t parse_options(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
     int *numbers = nullptr;
 
     try {
         size_t n = 0, k = 0;
 
+        const auto options = parse_options(argc, argv);
+
         std::cin >> n;
         if (n <= 0) {
             throw std::bad_exception();
@@ -30,13 +44,23 @@ int main() {
             throw std::bad_exception();
         }
 
+        if (options.isApproximate) {
+            QuantileSketch<int> sketch;
+            for (size_t i = 0; i < n; ++i) {
+                int number = 0;
+                std::cin >> number;
+                sketch.Insert(number);
+            }
+            std::cout << sketch.GetKthValue(k);
+            return 0;
+        }
 
         numbers = new int[n];
         for (size_t i = 0; i < n; ++i) {
             std::cin >> numbers[i];
         }
 
-        auto k_stat = find_k_stat<int>(numbers, n, k);
+        auto k_stat = select_k_stat<int>(numbers, n, k, options.strategy);
         std::cout << k_stat;
     }
     catch (std::bad_alloc& badAllocExc) {
@@ -45,6 +69,9 @@ int main() {
     catch (std::bad_exception& badInputExc) {
         PRINT_ERROR(std::string("[Input: N > 0; 0 <= K < N]"));
     }
+    catch (std::invalid_argument& badArgExc) {
+        PRINT_ERROR(std::string("[Usage: task06 [--strategy=random|introselect|floyd-rivest|parallel|block|three-way] [--approximate]]"));
+    }
     catch (...) {
         PRINT_ERROR("[error]");
     }
@@ -54,4 +81,44 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+options_t parse_options(int argc, char *argv[]) {
+    static const char STRATEGY_ARG[] = "--strategy=";
+    static const char APPROXIMATE_ARG[] = "--approximate";
+    static const struct {
+        const char *name;
+        SelectStrategy strategy;
+    } STRATEGIES[] = {
+        {"random", SelectStrategy::RANDOM},
+        {"introselect", SelectStrategy::INTROSELECT},
+        {"floyd-rivest", SelectStrategy::FLOYD_RIVEST},
+        {"parallel", SelectStrategy::PARALLEL},
+        {"block", SelectStrategy::BLOCK},
+        {"three-way", SelectStrategy::THREE_WAY}
+    };
+
+    options_t options;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], APPROXIMATE_ARG)) {
+            options.isApproximate = true;
+            continue;
+        }
+        if (strncmp(argv[i], STRATEGY_ARG, sizeof(STRATEGY_ARG) - 1)) {
+            throw std::invalid_argument(argv[i]);
+        }
+
+        const auto name = argv[i] + sizeof(STRATEGY_ARG) - 1;
+        auto isKnown = false;
+        for (auto &known : STRATEGIES) {
+            if (!strcmp(name, known.name)) {
+                options.strategy = known.strategy;
+                isKnown = true;
+            }
+        }
+        if (!isKnown) {
+            throw std::invalid_argument(name);
+        }
+    }
+    return options;
+}
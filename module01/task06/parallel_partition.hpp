@@ -0,0 +1,191 @@
+#ifndef PARALLEL_PARTITION_HPP
+#define PARALLEL_PARTITION_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+// Копия пары из task05/sort.h (она же в task07/radix_sort.hpp): задачи собираются
+// отдельно. Общий макрос позволяет копиям встретиться в одной единице трансляции.
+#ifndef RUN_IN_PARALLEL_DEFINED
+#define RUN_IN_PARALLEL_DEFINED
+
+template <typename F>
+void run_in_parallel(size_t numThreads, F &&task) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (size_t t = 1; t < numThreads; ++t) {
+        threads.emplace_back(task, t);
+    }
+    task(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+inline size_t default_num_threads() {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+#endif //RUN_IN_PARALLEL_DEFINED
+
+// Пока подмассив велик, он разбивается параллельно; дальше - последовательный introselect.
+// Если параллельное разбиение не сократило подмассив хотя бы на четверть
+// (например, из-за повторов), оставшаяся часть также решается introselect.
+template <typename T>
+T &parallel_select(T *array, size_t n, size_t k, compare_f(compFunc), size_t numThreads) {
+    assert(array && compFunc);
+    assert(n > 0 && k < n);
+
+    if (!numThreads) {
+        numThreads = default_num_threads();
+    }
+
+    XorShiftRandom random(make_select_seed(array, n, k));
+
+    size_t firstIndex = 0;
+    size_t lastIndex = n - 1;
+
+    while (numThreads > 1 && lastIndex - firstIndex + 1 >= PARALLEL_PARTITION_MIN_LENGTH) {
+        const auto length = lastIndex - firstIndex + 1;
+
+        auto pivotIndex = select_pivot_sampled(array, firstIndex, lastIndex, random, compFunc);
+        auto p = parallel_partition_around(array, firstIndex, lastIndex, pivotIndex, compFunc, numThreads);
+        if (p < k) {
+            firstIndex = p + 1;
+        }
+        else if (p > k) {
+            lastIndex = p - 1;
+        }
+        else {
+            return array[p];
+        }
+
+        if (lastIndex - firstIndex + 1 > length - (length >> 2)) {
+            break;
+        }
+    }
+
+    return introselect(array + firstIndex, lastIndex - firstIndex + 1, k - firstIndex, compFunc);
+}
+
+// Разбиение с тем же контрактом, что и partition_around: элементы, не большие
+// опорного, оказываются левее возвращаемой позиции, большие - правее.
+// 1) Каждый поток разбивает свой блок на месте.
+// 2) Большие элементы левее общей границы и не большие правее неё образуют
+//    списки интервалов одинаковой суммарной длины; потоки меняют их попарно.
+template <typename T>
+size_t parallel_partition_around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+                                 compare_f(compFunc), size_t numThreads) {
+    assert(array && compFunc);
+    assert(firstIndex <= pivotIndex && pivotIndex <= lastIndex);
+
+    if (!numThreads) {
+        numThreads = default_num_threads();
+    }
+
+    std::swap(array[firstIndex], array[pivotIndex]);
+    const T pivot = array[firstIndex];
+
+    // Разбивается [first, last), опорный элемент остаётся в firstIndex.
+    const size_t first = firstIndex + 1;
+    const size_t last = lastIndex + 1;
+    const size_t length = last - first;
+    numThreads = std::max<size_t>(std::min(numThreads, length), 1);
+
+    std::vector<size_t> chunkBounds(numThreads + 1);
+    std::vector<size_t> chunkSplits(numThreads);
+    for (size_t t = 0; t <= numThreads; ++t) {
+        chunkBounds[t] = first + length * t / numThreads;
+    }
+
+    run_in_parallel(numThreads, [&](size_t t) {
+        size_t i = chunkBounds[t], j = chunkBounds[t + 1];
+        while (true) {
+            while (i < j && compFunc(array[i], pivot) <= 0) {
+                ++i;
+            }
+            while (i < j && compFunc(array[j - 1], pivot) > 0) {
+                --j;
+            }
+            if (i >= j) {
+                break;
+            }
+            std::swap(array[i++], array[--j]);
+        }
+        chunkSplits[t] = i;
+    });
+
+    size_t boundary = first;
+    for (size_t t = 0; t < numThreads; ++t) {
+        boundary += chunkSplits[t] - chunkBounds[t];
+    }
+
+    struct interval_t {
+        size_t first;
+        size_t last;
+    };
+
+    // misplacedGreater - большие элементы левее границы, misplacedLess - не большие правее.
+    std::vector<interval_t> misplacedGreater, misplacedLess;
+    for (size_t t = 0; t < numThreads; ++t) {
+        const auto greaterLast = std::min(chunkBounds[t + 1], boundary);
+        if (chunkSplits[t] < greaterLast) {
+            misplacedGreater.push_back({chunkSplits[t], greaterLast});
+        }
+        const auto lessFirst = std::max(chunkBounds[t], boundary);
+        if (lessFirst < chunkSplits[t]) {
+            misplacedLess.push_back({lessFirst, chunkSplits[t]});
+        }
+    }
+
+    auto prefix_lengths = [](const std::vector<interval_t> &intervals) {
+        std::vector<size_t> prefix(intervals.size() + 1, 0);
+        for (size_t i = 0; i < intervals.size(); ++i) {
+            prefix[i + 1] = prefix[i] + intervals[i].last - intervals[i].first;
+        }
+        return prefix;
+    };
+    const auto greaterPrefix = prefix_lengths(misplacedGreater);
+    const auto lessPrefix = prefix_lengths(misplacedLess);
+    const auto numMisplaced = greaterPrefix.back();
+    assert(numMisplaced == lessPrefix.back());
+
+    if (numMisplaced) {
+        // Позиция m-го элемента в списке интервалов.
+        auto locate = [](const std::vector<interval_t> &intervals, const std::vector<size_t> &prefix,
+                         size_t m, size_t &interval) {
+            interval = static_cast<size_t>(std::upper_bound(prefix.begin(), prefix.end(), m) - prefix.begin()) - 1;
+            return intervals[interval].first + (m - prefix[interval]);
+        };
+
+        const auto numSwapThreads = std::min(numThreads, numMisplaced);
+        run_in_parallel(numSwapThreads, [&](size_t t) {
+            const auto begin = numMisplaced * t / numSwapThreads;
+            const auto end = numMisplaced * (t + 1) / numSwapThreads;
+            if (begin == end) {
+                return;
+            }
+
+            size_t g = 0, l = 0;
+            auto i = locate(misplacedGreater, greaterPrefix, begin, g);
+            auto j = locate(misplacedLess, lessPrefix, begin, l);
+            for (auto m = begin; m < end; ++m) {
+                if (i == misplacedGreater[g].last) {
+                    i = misplacedGreater[++g].first;
+                }
+                if (j == misplacedLess[l].last) {
+                    j = misplacedLess[++l].first;
+                }
+                std::swap(array[i++], array[j++]);
+            }
+        });
+    }
+
+    const auto pivotPosition = boundary - 1;
+    std::swap(array[firstIndex], array[pivotPosition]);
+    return pivotPosition;
+}
+
+#endif //PARALLEL_PARTITION_HPP
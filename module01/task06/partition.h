@@ -2,22 +2,99 @@
 #define PARTITION_H
 
 #include <cstddef>
+#include <cstdint>
+#include <utility>
 
 #define compare_f(f) \
     int (*f)(const T &left, const T &right)
 
+#define partition_f(f) \
+    size_t (*f)(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex, compare_f(compFunc))
+
+enum class SelectStrategy {
+    RANDOM,
+    INTROSELECT,
+    FLOYD_RIVEST,
+    PARALLEL,
+    BLOCK,
+    THREE_WAY
+};
+
+// TWO_WAY: части <= и > опорного; THREE_WAY: <, == и >, поиск заканчивается,
+// как только k попадает в часть ==.
+enum class PartitionMode {
+    TWO_WAY,
+    THREE_WAY
+};
+
+#define PARALLEL_PARTITION_MIN_LENGTH (1 << 20)
+
 template <typename T>
 int default_compare(const T &first, const T &second);
 
 template <typename T>
-T &find_k_stat(T *array, size_t n, size_t k, compare_f(compFunc) = default_compare);
+T &find_k_stat(T *array, size_t n, size_t k, compare_f(compFunc) = default_compare,
+               PartitionMode mode = PartitionMode::TWO_WAY);
+
+template <typename T>
+T &introselect(T *array, size_t n, size_t k, compare_f(compFunc) = default_compare);
+
+template <typename T>
+T &introselect(T *array, size_t n, size_t k, compare_f(compFunc), partition_f(partitionFunc));
+
+template <typename T>
+T &block_select(T *array, size_t n, size_t k, compare_f(compFunc) = default_compare);
+
+template <typename T>
+T &floyd_rivest_select(T *array, size_t n, size_t k, compare_f(compFunc) = default_compare);
+
+template <typename T>
+void floyd_rivest_select(T *array, size_t firstIndex, size_t lastIndex, size_t k, compare_f(compFunc));
+
+template <typename T>
+T &parallel_select(T *array, size_t n, size_t k, compare_f(compFunc) = default_compare, size_t numThreads = 0);
+
+template <typename T>
+void find_k_stats(T *array, size_t n, const size_t *ks, size_t numKs, T *results,
+                  compare_f(compFunc) = default_compare);
+
+template <typename T>
+T &select_k_stat(T *array, size_t n, size_t k, SelectStrategy strategy, compare_f(compFunc) = default_compare);
+
+template <typename T>
+T &select_median_of_medians(T *array, size_t firstIndex, size_t lastIndex, size_t k,
+                            compare_f(compFunc) = default_compare);
 
 template <typename T>
 size_t partition(T *array, size_t firstIndex, size_t lastIndex, compare_f(compFunc) = default_compare);
 
+template <typename T>
+size_t partition_around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+                        compare_f(compFunc) = default_compare);
+
+template <typename T>
+size_t parallel_partition_around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+                                 compare_f(compFunc) = default_compare, size_t numThreads = 0);
+
+template <typename T>
+size_t block_partition_around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+                              compare_f(compFunc) = default_compare);
+
+template <typename T>
+std::pair<size_t, size_t> partition_three_way(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+                                              compare_f(compFunc) = default_compare);
+
 template <typename T>
 size_t select_pivot(const T *array, size_t firstIndex, size_t lastIndex, compare_f(compFunc) = default_compare);
 
+class XorShiftRandom;
+
+template <typename T>
+size_t select_pivot_sampled(const T *array, size_t firstIndex, size_t lastIndex, XorShiftRandom &random,
+                            compare_f(compFunc) = default_compare);
+
 #include "partition.hpp"
+#include "parallel_partition.hpp"
+#include "block_partition.hpp"
 
 #endif //PARTITION_H
@@ -3,18 +3,75 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
 
 #define HALF(x) \
     ((x) >> 1)
 
+#define NINTHER_MIN_LENGTH 128
+#define MEDIAN_OF_MEDIANS_GROUP 5
+#define FLOYD_RIVEST_MIN_LENGTH 600
+#define INTROSELECT_HALVING_ROUNDS 4
+
+// Быстрый генератор xorshift64* с состоянием на один вызов: не использует
+// глобальное состояние rand() и безопасен для потоков.
+class XorShiftRandom {
+    public:
+        explicit XorShiftRandom(uint64_t seed) {
+            // splitmix64, чтобы близкие зёрна давали разные последовательности.
+            seed += 0x9E3779B97F4A7C15ull;
+            seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+            state = (seed ^ (seed >> 31)) | 1;
+        }
+
+        uint64_t Next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 0x2545F4914F6CDD1Dull;
+        }
+
+        // Равномерно распределённый индекс из [firstIndex, lastIndex].
+        size_t NextIndex(size_t firstIndex, size_t lastIndex) {
+            const auto range = static_cast<uint64_t>(lastIndex - firstIndex) + 1;
+            return firstIndex + static_cast<size_t>(range ? Next() % range : Next());
+        }
+
+    private:
+        uint64_t state = 1;
+};
+
+inline uint64_t make_select_seed(const void *array, size_t n, size_t k) {
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+           reinterpret_cast<uintptr_t>(array) ^ (static_cast<uint64_t>(n) << 32) ^ k;
+}
+
 template <typename T>
-T &find_k_stat(T *array, size_t n, size_t k, compare_f(compFunc)) {
+T &find_k_stat(T *array, size_t n, size_t k, compare_f(compFunc), PartitionMode mode) {
     assert(array && compFunc);
     assert(n > 0 && k >= 0 && k < n);
 
     size_t firstIndex = 0;
     size_t lastIndex = n - 1;
 
+    while (mode == PartitionMode::THREE_WAY) {
+        size_t pivotIndex = select_pivot(array, firstIndex, lastIndex, compFunc);
+        auto bounds = partition_three_way(array, firstIndex, lastIndex, pivotIndex, compFunc);
+        if (k < bounds.first) {
+            lastIndex = bounds.first - 1;
+        }
+        else if (k >= bounds.second) {
+            firstIndex = bounds.second;
+        }
+        else {
+            return array[k];
+        }
+    }
+
     while (true) {
         size_t p = partition(array, firstIndex, lastIndex, compFunc);
         if (p < k) {
@@ -29,11 +86,244 @@ T &find_k_stat(T *array, size_t n, size_t k, compare_f(compFunc)) {
     }
 }
 
+// Быстрый выбор с выборочной медианой в качестве опорного элемента. Если за
+// INTROSELECT_HALVING_ROUNDS разбиений подмассив не сократился хотя бы вдвое,
+// оставшаяся часть решается методом медианы медиан - худший случай O(n).
+// Выборочная медиана заметно разбросана, поэтому двух разбиений для проверки мало.
+template <typename T>
+T &introselect(T *array, size_t n, size_t k, compare_f(compFunc)) {
+    return introselect(array, n, k, compFunc, partition_around<T>);
+}
+
+// partitionFunc должна соблюдать контракт partition_around.
+template <typename T>
+T &introselect(T *array, size_t n, size_t k, compare_f(compFunc), partition_f(partitionFunc)) {
+    assert(array && compFunc && partitionFunc);
+    assert(n > 0 && k < n);
+
+    XorShiftRandom random(make_select_seed(array, n, k));
+
+    size_t firstIndex = 0;
+    size_t lastIndex = n - 1;
+
+    size_t checkpointLength = n;
+    size_t numRounds = 0;
+
+    while (firstIndex < lastIndex) {
+        const auto length = lastIndex - firstIndex + 1;
+        if (numRounds == INTROSELECT_HALVING_ROUNDS) {
+            if (length > HALF(checkpointLength)) {
+                return select_median_of_medians(array, firstIndex, lastIndex, k, compFunc);
+            }
+            checkpointLength = length;
+            numRounds = 0;
+        }
+        ++numRounds;
+
+        auto pivotIndex = select_pivot_sampled(array, firstIndex, lastIndex, random, compFunc);
+        size_t p = partitionFunc(array, firstIndex, lastIndex, pivotIndex, compFunc);
+        if (p < k) {
+            firstIndex = p + 1;
+        }
+        else if (p > k) {
+            lastIndex = p - 1;
+        }
+        else {
+            return array[p];
+        }
+    }
+
+    return array[firstIndex];
+}
+
+// Выбор Флойда-Ривеста: опорный элемент берётся как k-я статистика небольшой
+// выборки, смещённой так, чтобы k почти наверняка попала в меньшую часть
+// разбиения. В среднем около n + min(k, n - k) сравнений.
+template <typename T>
+T &floyd_rivest_select(T *array, size_t n, size_t k, compare_f(compFunc)) {
+    assert(array && compFunc);
+    assert(n > 0 && k < n);
+
+    floyd_rivest_select(array, 0, n - 1, k, compFunc);
+    return array[k];
+}
+
+template <typename T>
+void floyd_rivest_select(T *array, size_t firstIndex, size_t lastIndex, size_t k, compare_f(compFunc)) {
+    while (firstIndex < lastIndex) {
+        const auto length = lastIndex - firstIndex + 1;
+        if (length > FLOYD_RIVEST_MIN_LENGTH) {
+            const double n = static_cast<double>(length);
+            const double i = static_cast<double>(k - firstIndex + 1);
+            const double z = std::log(n);
+            const double s = 0.5 * std::exp(2 * z / 3);
+            const double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+
+            const double sampleFirst = static_cast<double>(k) - i * s / n + sd;
+            const double sampleLast = static_cast<double>(k) + (n - i) * s / n + sd;
+            const auto newFirst = std::max(firstIndex, static_cast<size_t>(std::max(sampleFirst, 0.0)));
+            const auto newLast = std::min(lastIndex, static_cast<size_t>(std::max(sampleLast, 0.0)));
+
+            // Элемент выборки ставится на место k и служит опорным.
+            floyd_rivest_select(array, newFirst, newLast, k, compFunc);
+        }
+
+        // Трёхчастное разбиение: при множестве равных ключей k сразу попадает в часть ==.
+        const auto bounds = partition_three_way(array, firstIndex, lastIndex, k, compFunc);
+        if (k < bounds.first) {
+            lastIndex = bounds.first - 1;
+        }
+        else if (k >= bounds.second) {
+            firstIndex = bounds.second;
+        }
+        else {
+            return;
+        }
+    }
+}
+
+// Несколько порядковых статистик за один проход: подмассив разбивается, пока
+// в нём есть запрошенные ранги, и спуск идёт только в части, содержащие их.
+// При q рангах - O(n log q) в среднем. results[i] - ks[i]-я статистика.
+template <typename T>
+void find_k_stats(T *array, size_t n, const size_t *ks, size_t numKs, T *results, compare_f(compFunc)) {
+    assert(array && ks && results && compFunc);
+    assert(n > 0);
+
+    std::vector<size_t> ranks(ks, ks + numKs);
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    assert(ranks.empty() || ranks.back() < n);
+
+    struct range_t {
+        size_t firstIndex;
+        size_t lastIndex;
+        size_t firstRank;
+        size_t lastRank;
+    };
+
+    XorShiftRandom random(make_select_seed(array, n, numKs));
+
+    // Диапазоны не пересекаются, поэтому уже найденные позиции не портятся.
+    std::vector<range_t> ranges;
+    if (!ranks.empty()) {
+        ranges.push_back({0, n - 1, 0, ranks.size()});
+    }
+
+    while (!ranges.empty()) {
+        auto range = ranges.back();
+        ranges.pop_back();
+
+        if (range.lastRank - range.firstRank == 1) {
+            introselect(array + range.firstIndex, range.lastIndex - range.firstIndex + 1,
+                        ranks[range.firstRank] - range.firstIndex, compFunc);
+            continue;
+        }
+
+        // Трёхчастное разбиение: ранги, попавшие в часть ==, найдены сразу.
+        auto pivotIndex = select_pivot_sampled(array, range.firstIndex, range.lastIndex, random, compFunc);
+        auto bounds = partition_three_way(array, range.firstIndex, range.lastIndex, pivotIndex, compFunc);
+
+        auto rankBegin = ranks.begin() + range.firstRank;
+        auto rankEnd = ranks.begin() + range.lastRank;
+        auto lower = static_cast<size_t>(std::lower_bound(rankBegin, rankEnd, bounds.first) - ranks.begin());
+        auto upper = static_cast<size_t>(std::lower_bound(rankBegin, rankEnd, bounds.second) - ranks.begin());
+
+        if (range.firstRank < lower) {
+            ranges.push_back({range.firstIndex, bounds.first - 1, range.firstRank, lower});
+        }
+        if (upper < range.lastRank) {
+            ranges.push_back({bounds.second, range.lastIndex, upper, range.lastRank});
+        }
+    }
+
+    for (size_t i = 0; i < numKs; ++i) {
+        results[i] = array[ks[i]];
+    }
+}
+
+template <typename T>
+T &select_k_stat(T *array, size_t n, size_t k, SelectStrategy strategy, compare_f(compFunc)) {
+    switch (strategy) {
+        case SelectStrategy::INTROSELECT:
+            return introselect(array, n, k, compFunc);
+
+        case SelectStrategy::FLOYD_RIVEST:
+            return floyd_rivest_select(array, n, k, compFunc);
+
+        case SelectStrategy::PARALLEL:
+            return parallel_select(array, n, k, compFunc);
+
+        case SelectStrategy::BLOCK:
+            return block_select(array, n, k, compFunc);
+
+        case SelectStrategy::THREE_WAY:
+            return find_k_stat(array, n, k, compFunc, PartitionMode::THREE_WAY);
+
+        case SelectStrategy::RANDOM:
+        default:
+            return find_k_stat(array, n, k, compFunc);
+    }
+}
+
+template <typename T>
+void insertion_sort(T *array, size_t firstIndex, size_t lastIndex, compare_f(compFunc)) {
+    for (auto i = firstIndex + 1; i <= lastIndex; ++i) {
+        for (auto j = i; j > firstIndex && compFunc(array[j], array[j - 1]) < 0; --j) {
+            std::swap(array[j], array[j - 1]);
+        }
+    }
+}
+
+template <typename T>
+T &select_median_of_medians(T *array, size_t firstIndex, size_t lastIndex, size_t k, compare_f(compFunc)) {
+    assert(array && compFunc);
+    assert(firstIndex <= k && k <= lastIndex);
+
+    while (true) {
+        if (lastIndex - firstIndex < MEDIAN_OF_MEDIANS_GROUP) {
+            insertion_sort(array, firstIndex, lastIndex, compFunc);
+            return array[k];
+        }
+
+        // Медианы групп по 5 элементов переносятся в начало подмассива.
+        size_t numGroups = 0;
+        for (auto group = firstIndex; group <= lastIndex; group += MEDIAN_OF_MEDIANS_GROUP) {
+            const auto groupLast = std::min(group + MEDIAN_OF_MEDIANS_GROUP - 1, lastIndex);
+            insertion_sort(array, group, groupLast, compFunc);
+            std::swap(array[firstIndex + numGroups++], array[group + HALF(groupLast - group)]);
+        }
+
+        const auto medianIndex = firstIndex + HALF(numGroups - 1);
+        select_median_of_medians(array, firstIndex, firstIndex + numGroups - 1, medianIndex, compFunc);
+
+        // Трёхчастное разбиение не деградирует на равных элементах.
+        auto bounds = partition_three_way(array, firstIndex, lastIndex, medianIndex, compFunc);
+        if (k < bounds.first) {
+            lastIndex = bounds.first - 1;
+        }
+        else if (k >= bounds.second) {
+            firstIndex = bounds.second;
+        }
+        else {
+            return array[k];
+        }
+    }
+}
+
 template <typename T>
 size_t partition(T *array, size_t firstIndex, size_t lastIndex, compare_f(compFunc)) {
     assert(array && compFunc);
 
     size_t pivotIndex = select_pivot(array, firstIndex, lastIndex, compFunc);
+    return partition_around(array, firstIndex, lastIndex, pivotIndex, compFunc);
+}
+
+template <typename T>
+size_t partition_around(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex, compare_f(compFunc)) {
+    assert(array && compFunc);
+    assert(firstIndex <= pivotIndex && pivotIndex <= lastIndex);
+
     std::swap(array[firstIndex], array[pivotIndex]);
 
     size_t i = lastIndex, j = lastIndex;
@@ -51,6 +341,33 @@ size_t partition(T *array, size_t firstIndex, size_t lastIndex, compare_f(compFu
     return i;
 }
 
+// Разбиение Дейкстры на части <, == и > опорного элемента. Возвращает границы
+// части == : [first, second).
+template <typename T>
+std::pair<size_t, size_t> partition_three_way(T *array, size_t firstIndex, size_t lastIndex, size_t pivotIndex,
+                                              compare_f(compFunc)) {
+    assert(array && compFunc);
+    assert(firstIndex <= pivotIndex && pivotIndex <= lastIndex);
+
+    const T pivot = array[pivotIndex];
+
+    size_t less = firstIndex, i = firstIndex, greater = lastIndex + 1;
+    while (i < greater) {
+        const auto result = compFunc(array[i], pivot);
+        if (result < 0) {
+            std::swap(array[less++], array[i++]);
+        }
+        else if (result > 0) {
+            std::swap(array[i], array[--greater]);
+        }
+        else {
+            ++i;
+        }
+    }
+
+    return std::make_pair(less, greater);
+}
+
 template <typename T>
 int default_compare(const T &first, const T &second) {
     if (first == second) {
@@ -62,7 +379,45 @@ int default_compare(const T &first, const T &second) {
 template <typename T>
 size_t select_pivot(const T *array, size_t firstIndex, size_t lastIndex, compare_f(compFunc)) {
     assert(array && compFunc);
-    return firstIndex == lastIndex ? firstIndex : (rand() % (lastIndex - firstIndex)) + firstIndex;
+    return (rand() % (lastIndex - firstIndex + 1)) + firstIndex;
+}
+
+// Медиана трёх случайных элементов, для длинных подмассивов - медиана трёх медиан (ninther).
+template <typename T>
+size_t select_pivot_sampled(const T *array, size_t firstIndex, size_t lastIndex, XorShiftRandom &random,
+                            compare_f(compFunc)) {
+    assert(array && compFunc);
+
+    auto median_of_three = [&](size_t a, size_t b, size_t c) {
+        if (compFunc(array[a], array[b]) < 0) {
+            if (compFunc(array[b], array[c]) < 0) {
+                return b;
+            }
+            return compFunc(array[a], array[c]) < 0 ? c : a;
+        }
+        if (compFunc(array[a], array[c]) < 0) {
+            return a;
+        }
+        return compFunc(array[b], array[c]) < 0 ? c : b;
+    };
+    auto random_median_of_three = [&]() {
+        return median_of_three(random.NextIndex(firstIndex, lastIndex),
+                               random.NextIndex(firstIndex, lastIndex),
+                               random.NextIndex(firstIndex, lastIndex));
+    };
+
+    const auto length = lastIndex - firstIndex + 1;
+    if (length < 3) {
+        return random.NextIndex(firstIndex, lastIndex);
+    }
+    if (length < NINTHER_MIN_LENGTH) {
+        return random_median_of_three();
+    }
+
+    const auto first = random_median_of_three();
+    const auto second = random_median_of_three();
+    const auto third = random_median_of_three();
+    return median_of_three(first, second, third);
 }
 
 #endif //PARTITION_HPP
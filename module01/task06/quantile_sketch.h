@@ -0,0 +1,77 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "partition.h"
+
+#define QUANTILE_SKETCH_DEFAULT_K 200
+#define QUANTILE_SKETCH_MIN_CAPACITY 8
+
+// Эскиз KLL (Karnin, Lang, Liberty) для приближённых порядковых статистик потока.
+// Ёмкости уровней убывают геометрически, поэтому память - O(k + log(n / k)) элементов:
+// около 3k и ещё QUANTILE_SKETCH_MIN_CAPACITY на каждый из log(n / k) уровней.
+// Ранг ответа GetKthValue(rank) отличается от rank не более чем на
+// GetRankError() * n с вероятностью 99% (для k = 200 - около 1.3% от n). Эскизы частей потока, построенные
+// в разных потоках, объединяются методом Merge с той же гарантией.
+template <typename T>
+class QuantileSketch {
+    public:
+        typedef int (*compare_t)(const T &left, const T &right);
+
+        explicit QuantileSketch(size_t k = QUANTILE_SKETCH_DEFAULT_K, compare_t compFunc = default_compare);
+        QuantileSketch(const QuantileSketch &sketch) = default;
+        QuantileSketch(QuantileSketch &&sketch) noexcept = default;
+
+        ~QuantileSketch() = default;
+
+        QuantileSketch& operator=(const QuantileSketch &sketch) = default;
+        QuantileSketch& operator=(QuantileSketch &&sketch) noexcept = default;
+
+        void Insert(const T &item);
+        void Merge(const QuantileSketch &sketch);
+
+        // Приближённая rank-я порядковая статистика (0 <= rank < GetNumItems()).
+        T GetKthValue(size_t rank) const;
+        // Приближённое число элементов потока, меньших item.
+        size_t GetRank(const T &item) const;
+
+        double GetRankError() const;
+        size_t GetNumItems() const;
+        size_t GetNumRetained() const;
+        bool IsEmpty() const;
+        compare_t GetCompare() const;
+
+    private:
+        size_t k;
+        compare_t compFunc;
+
+        size_t numItems = 0;
+        size_t numRetained = 0;
+        size_t capacity = 0;
+        std::vector<size_t> levelCapacities;
+
+        // Элемент уровня h представляет 2^h элементов потока.
+        std::vector<std::vector<T>> levels;
+        XorShiftRandom random;
+
+        void UpdateCapacity();
+
+        void Compress();
+        void CompactLevel(size_t level);
+};
+
+// Точная k-я статистика потока за второй проход: по эскизу выбирается узкая
+// полоса значений вокруг k, в память собираются только элементы из неё,
+// и по ним работает find_k_stat. Если полоса не накрыла k (вероятность ~1%),
+// она расширяется и проход повторяется.
+// forEachItem(visit) должна вызвать visit(item) для каждого элемента того же
+// потока, по которому построен эскиз.
+template <typename T, typename F>
+T refine_k_stat(const QuantileSketch<T> &sketch, size_t k, F &&forEachItem);
+
+#include "quantile_sketch.hpp"
+
+#endif //QUANTILE_SKETCH_H
@@ -0,0 +1,209 @@
+#ifndef QUANTILE_SKETCH_HPP
+#define QUANTILE_SKETCH_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#define QUANTILE_SKETCH_CAPACITY_RATIO (2.0 / 3.0)
+
+template<typename T>
+QuantileSketch<T>::QuantileSketch(size_t k, compare_t compFunc) :
+        k(k), compFunc(compFunc), levels(1), random(make_select_seed(this, k, 0)) {
+    assert(k >= QUANTILE_SKETCH_MIN_CAPACITY && compFunc);
+    UpdateCapacity();
+}
+
+template<typename T>
+void QuantileSketch<T>::Insert(const T &item) {
+    levels[0].push_back(item);
+    ++numItems, ++numRetained;
+
+    if (numRetained > capacity) {
+        Compress();
+    }
+}
+
+template<typename T>
+void QuantileSketch<T>::Merge(const QuantileSketch &sketch) {
+    assert(k == sketch.k && compFunc == sketch.compFunc);
+
+    // Уровни эскиза меняются по ходу слияния - с самим собой сливается копия.
+    if (&sketch == this) {
+        const QuantileSketch copy(sketch);
+        Merge(copy);
+        return;
+    }
+
+    if (sketch.levels.size() > levels.size()) {
+        levels.resize(sketch.levels.size());
+        UpdateCapacity();
+    }
+    for (size_t level = 0; level < sketch.levels.size(); ++level) {
+        levels[level].insert(levels[level].end(), sketch.levels[level].begin(), sketch.levels[level].end());
+    }
+    numItems += sketch.numItems;
+    numRetained += sketch.numRetained;
+
+    while (numRetained > capacity) {
+        Compress();
+    }
+}
+
+template<typename T>
+T QuantileSketch<T>::GetKthValue(size_t rank) const {
+    assert(rank < numItems);
+
+    std::vector<std::pair<T, size_t>> weighted;
+    weighted.reserve(numRetained);
+    for (size_t level = 0; level < levels.size(); ++level) {
+        for (auto &item : levels[level]) {
+            weighted.emplace_back(item, size_t(1) << level);
+        }
+    }
+
+    auto compare = compFunc;
+    std::sort(weighted.begin(), weighted.end(), [compare](const std::pair<T, size_t> &left,
+                                                          const std::pair<T, size_t> &right) {
+        return compare(left.first, right.first) < 0;
+    });
+
+    size_t weight = 0;
+    for (auto &entry : weighted) {
+        weight += entry.second;
+        if (weight > rank) {
+            return entry.first;
+        }
+    }
+    return weighted.back().first;
+}
+
+template<typename T>
+size_t QuantileSketch<T>::GetRank(const T &item) const {
+    size_t rank = 0;
+    for (size_t level = 0; level < levels.size(); ++level) {
+        for (auto &retained : levels[level]) {
+            if (compFunc(retained, item) < 0) {
+                rank += size_t(1) << level;
+            }
+        }
+    }
+    return rank;
+}
+
+// Эмпирическая оценка для 99% доверия (Karnin, Lang, Liberty; Apache DataSketches).
+template<typename T>
+double QuantileSketch<T>::GetRankError() const {
+    return 2.296 / std::pow(static_cast<double>(k), 0.9723);
+}
+
+template<typename T>
+size_t QuantileSketch<T>::GetNumItems() const {
+    return numItems;
+}
+
+template<typename T>
+size_t QuantileSketch<T>::GetNumRetained() const {
+    return numRetained;
+}
+
+template<typename T>
+bool QuantileSketch<T>::IsEmpty() const {
+    return !numItems;
+}
+
+template<typename T>
+typename QuantileSketch<T>::compare_t QuantileSketch<T>::GetCompare() const {
+    return compFunc;
+}
+
+// Ёмкость уровня убывает геометрически от верхнего уровня (k) к нижним.
+template<typename T>
+void QuantileSketch<T>::UpdateCapacity() {
+    levelCapacities.resize(levels.size());
+    capacity = 0;
+    for (size_t level = 0; level < levels.size(); ++level) {
+        const auto depth = static_cast<double>(levels.size() - 1 - level);
+        const auto levelCapacity = std::ceil(k * std::pow(QUANTILE_SKETCH_CAPACITY_RATIO, depth));
+        levelCapacities[level] = std::max<size_t>(QUANTILE_SKETCH_MIN_CAPACITY, static_cast<size_t>(levelCapacity));
+        capacity += levelCapacities[level];
+    }
+}
+
+// Уплотняется самый нижний переполненный уровень.
+template<typename T>
+void QuantileSketch<T>::Compress() {
+    for (size_t level = 0; level < levels.size(); ++level) {
+        if (levels[level].size() >= levelCapacities[level]) {
+            CompactLevel(level);
+            return;
+        }
+    }
+    assert(false);
+}
+
+// Уровень сортируется, и каждый второй элемент (со случайным сдвигом) переходит
+// на уровень выше с удвоенным весом. При нечётном размере один элемент остаётся.
+template<typename T>
+void QuantileSketch<T>::CompactLevel(size_t level) {
+    if (level + 1 == levels.size()) {
+        levels.emplace_back();
+        UpdateCapacity();
+    }
+
+    auto &items = levels[level];
+    auto &nextItems = levels[level + 1];
+
+    auto compare = compFunc;
+    std::sort(items.begin(), items.end(), [compare](const T &left, const T &right) {
+        return compare(left, right) < 0;
+    });
+
+    const size_t first = items.size() & 1;
+    const size_t offset = random.Next() & 1;
+    const auto numPromoted = HALF(items.size() - first);
+    for (auto i = first + offset; i < items.size(); i += 2) {
+        nextItems.push_back(items[i]);
+    }
+    items.resize(first);
+    numRetained -= numPromoted;
+}
+
+template <typename T, typename F>
+T refine_k_stat(const QuantileSketch<T> &sketch, size_t k, F &&forEachItem) {
+    const auto n = sketch.GetNumItems();
+    assert(k < n);
+
+    const auto compFunc = sketch.GetCompare();
+    auto margin = static_cast<size_t>(std::ceil(sketch.GetRankError() * n)) + 1;
+    std::vector<T> band;
+
+    while (true) {
+        const bool hasLow = k >= margin;
+        const bool hasHigh = n - k > margin;
+        const T low = hasLow ? sketch.GetKthValue(k - margin) : T();
+        const T high = hasHigh ? sketch.GetKthValue(k + margin) : T();
+
+        size_t numBelow = 0;
+        band.clear();
+        forEachItem([&](const T &item) {
+            if (hasLow && compFunc(item, low) < 0) {
+                ++numBelow;
+            }
+            else if (!hasHigh || compFunc(item, high) <= 0) {
+                band.push_back(item);
+            }
+        });
+        assert(numBelow + band.size() <= n);
+
+        if (numBelow <= k && k < numBelow + band.size()) {
+            return find_k_stat(band.data(), band.size(), k - numBelow, compFunc, PartitionMode::THREE_WAY);
+        }
+
+        // Без границ полоса содержит весь поток, поэтому цикл конечен.
+        margin *= 4;
+    }
+}
+
+#endif //QUANTILE_SKETCH_HPP
@@ -0,0 +1,62 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <cstddef>
+#include <vector>
+
+#include "partition.h"
+
+#define SORT_INSERTION_MAX_LENGTH 16
+// top_k переходит на кучу, когда k * TOP_K_HEAP_RATIO <= n.
+#define TOP_K_HEAP_RATIO 4096
+
+// Упорядочивает k наименьших элементов в array[0..k); порядок остальных не определён.
+// Выбор k-1-й статистики через block_select, затем сортировка только префикса.
+template <typename T>
+void partial_sort(T *array, size_t n, size_t k, compare_f(compFunc) = default_compare);
+
+// Записывает k наименьших элементов array в out по возрастанию, не изменяя array.
+template <typename T>
+void top_k(const T *array, size_t n, size_t k, T *out, compare_f(compFunc) = default_compare);
+
+// Нерекурсивная быстрая сортировка [firstIndex, lastIndex] с блочным разбиением;
+// при слишком глубоком разбиении подмассив досортировывается пирамидальной сортировкой.
+template <typename T>
+void sort_range(T *array, size_t firstIndex, size_t lastIndex, compare_f(compFunc) = default_compare);
+
+// k наименьших элементов потока в куче с максимумом в корне: элемент не меньше
+// максимума отбрасывается за одно сравнение, поэтому при k << n поток
+// обрабатывается почти за n сравнений и O(k) памяти.
+template <typename T>
+class TopKHeap {
+    public:
+        typedef int (*compare_t)(const T &left, const T &right);
+
+        explicit TopKHeap(size_t k, compare_t compFunc = default_compare);
+        TopKHeap(const TopKHeap &heap) = default;
+        TopKHeap(TopKHeap &&heap) noexcept = default;
+
+        ~TopKHeap() = default;
+
+        TopKHeap& operator=(const TopKHeap &heap) = default;
+        TopKHeap& operator=(TopKHeap &&heap) noexcept = default;
+
+        void Insert(const T &item);
+        // Записывает накопленные элементы в out по возрастанию и очищает кучу.
+        void ExtractSorted(T *out);
+
+        size_t GetNumItems() const;
+        bool IsEmpty() const;
+
+    private:
+        size_t k;
+        compare_t compFunc;
+        std::vector<T> items;
+
+        void SiftUp(size_t index);
+        void SiftDown(size_t index);
+};
+
+#include "top_k.hpp"
+
+#endif //TOP_K_H
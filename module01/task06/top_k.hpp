@@ -0,0 +1,184 @@
+#ifndef TOP_K_HPP
+#define TOP_K_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+template <typename T>
+void partial_sort(T *array, size_t n, size_t k, compare_f(compFunc)) {
+    assert(array && compFunc);
+    assert(k <= n);
+
+    if (!k) {
+        return;
+    }
+    if (k == n) {
+        sort_range(array, 0, n - 1, compFunc);
+        return;
+    }
+
+    // После выбора array[0..k-1) не больше array[k - 1].
+    block_select(array, n, k - 1, compFunc);
+    if (k > 1) {
+        sort_range(array, 0, k - 2, compFunc);
+    }
+}
+
+template <typename T>
+void top_k(const T *array, size_t n, size_t k, T *out, compare_f(compFunc)) {
+    assert(array && compFunc && (out || !k));
+    assert(k <= n);
+
+    if (!k) {
+        return;
+    }
+
+    if (k * TOP_K_HEAP_RATIO <= n) {
+        TopKHeap<T> heap(k, compFunc);
+        for (size_t i = 0; i < n; ++i) {
+            heap.Insert(array[i]);
+        }
+        heap.ExtractSorted(out);
+        return;
+    }
+
+    std::vector<T> buffer(array, array + n);
+    partial_sort(buffer.data(), n, k, compFunc);
+    std::copy(buffer.begin(), buffer.begin() + k, out);
+}
+
+template <typename T>
+void sort_range(T *array, size_t firstIndex, size_t lastIndex, compare_f(compFunc)) {
+    assert(array && compFunc);
+    assert(firstIndex <= lastIndex);
+
+    typedef struct {
+        size_t firstIndex;
+        size_t lastIndex;
+        size_t depthLimit;
+    } range_t;
+
+    size_t depthLimit = 0;
+    for (auto length = lastIndex - firstIndex + 1; length > 1; length >>= 1) {
+        depthLimit += 2;
+    }
+
+    XorShiftRandom random(make_select_seed(array, firstIndex, lastIndex));
+    std::vector<range_t> ranges;
+    ranges.push_back({firstIndex, lastIndex, depthLimit});
+
+    auto less = [compFunc](const T &left, const T &right) {
+        return compFunc(left, right) < 0;
+    };
+
+    while (!ranges.empty()) {
+        auto range = ranges.back();
+        ranges.pop_back();
+
+        while (range.lastIndex - range.firstIndex + 1 > SORT_INSERTION_MAX_LENGTH) {
+            if (!range.depthLimit--) {
+                std::make_heap(array + range.firstIndex, array + range.lastIndex + 1, less);
+                std::sort_heap(array + range.firstIndex, array + range.lastIndex + 1, less);
+                break;
+            }
+
+            auto pivotIndex = select_pivot_sampled(array, range.firstIndex, range.lastIndex, random, compFunc);
+            auto p = block_partition_around(array, range.firstIndex, range.lastIndex, pivotIndex, compFunc);
+
+            // Меньшая часть обрабатывается сразу, поэтому стек - O(log n).
+            range_t left = {range.firstIndex, p > range.firstIndex ? p - 1 : range.firstIndex, range.depthLimit};
+            range_t right = {std::min(p + 1, range.lastIndex), range.lastIndex, range.depthLimit};
+            if (p - range.firstIndex < range.lastIndex - p) {
+                ranges.push_back(right);
+                range = left;
+            }
+            else {
+                ranges.push_back(left);
+                range = right;
+            }
+        }
+
+        if (range.lastIndex - range.firstIndex + 1 <= SORT_INSERTION_MAX_LENGTH) {
+            insertion_sort(array, range.firstIndex, range.lastIndex, compFunc);
+        }
+    }
+}
+
+template<typename T>
+TopKHeap<T>::TopKHeap(size_t k, compare_t compFunc) : k(k), compFunc(compFunc) {
+    assert(k > 0 && compFunc);
+    items.reserve(k);
+}
+
+template<typename T>
+void TopKHeap<T>::Insert(const T &item) {
+    if (items.size() < k) {
+        items.push_back(item);
+        SiftUp(items.size() - 1);
+    }
+    else if (compFunc(item, items[0]) < 0) {
+        items[0] = item;
+        SiftDown(0);
+    }
+}
+
+template<typename T>
+void TopKHeap<T>::ExtractSorted(T *out) {
+    assert(out || items.empty());
+
+    for (auto i = items.size(); i > 0; --i) {
+        std::swap(items[0], items.back());
+        out[i - 1] = std::move(items.back());
+        items.pop_back();
+        if (!items.empty()) {
+            SiftDown(0);
+        }
+    }
+}
+
+template<typename T>
+size_t TopKHeap<T>::GetNumItems() const {
+    return items.size();
+}
+
+template<typename T>
+bool TopKHeap<T>::IsEmpty() const {
+    return items.empty();
+}
+
+template<typename T>
+void TopKHeap<T>::SiftUp(size_t index) {
+    while (index > 0) {
+        const auto parent = (index - 1) >> 1;
+        if (compFunc(items[parent], items[index]) >= 0) {
+            return;
+        }
+        std::swap(items[parent], items[index]);
+        index = parent;
+    }
+}
+
+template<typename T>
+void TopKHeap<T>::SiftDown(size_t index) {
+    const auto numItems = items.size();
+    while (true) {
+        const auto left = 2 * index + 1;
+        if (left >= numItems) {
+            return;
+        }
+
+        auto largest = left;
+        if (left + 1 < numItems && compFunc(items[left + 1], items[left]) > 0) {
+            largest = left + 1;
+        }
+        if (compFunc(items[index], items[largest]) >= 0) {
+            return;
+        }
+
+        std::swap(items[index], items[largest]);
+        index = largest;
+    }
+}
+
+#endif //TOP_K_HPP
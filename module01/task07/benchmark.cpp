@@ -0,0 +1,301 @@
+/* Замеры производительности поразрядной сортировки.
+ * Запуск: task07_benchmark [n]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+
+#include "radix_sort.h"
+#include "string_sort.h"
+
+#define DEFAULT_BENCHMARK_LENGTH 10000000
+#define STRING_BENCHMARK_MAX_LENGTH 2000000
+
+typedef std::vector<uint64_t> array_t;
+
+template <typename F>
+double measure_seconds(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void print_result(const std::string &name, double seconds, double baseline) {
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3) << seconds << " s"
+              << std::setw(10) << std::setprecision(2) << baseline / seconds << "x";
+}
+
+array_t make_random_array(size_t n, size_t numBits) {
+    std::mt19937_64 generator(42);
+
+    array_t array(n);
+    for (auto &x : array) {
+        x = numBits < 64 ? generator() >> (64 - numBits) : generator();
+    }
+    return array;
+}
+
+void fail(const std::string &message) {
+    std::cerr << "[" << message << "]" << std::endl;
+    std::exit(1);
+}
+
+void benchmark_lsd_sort(size_t n, size_t numBits) {
+    const auto input = make_random_array(n, numBits);
+
+    std::cout << "--- n = " << n << ", " << numBits << "-bit keys ---" << std::endl;
+
+    auto sorted = input;
+    const auto baseline = measure_seconds([&]() {
+        std::sort(sorted.begin(), sorted.end());
+    });
+    print_result("std::sort", baseline, baseline);
+    std::cout << std::endl;
+
+    auto array = input;
+    auto seconds = measure_seconds([&]() {
+        lsd_sort(array.data(), n);
+    });
+    if (array != sorted) {
+        fail("lsd_sort: wrong order");
+    }
+    print_result("lsd_sort", seconds, baseline);
+    std::cout << std::endl;
+
+    array = input;
+    seconds = measure_seconds([&]() {
+        msd_sort(array.data(), n);
+    });
+    if (array != sorted) {
+        fail("msd_sort: wrong order");
+    }
+    print_result("msd_sort (in place)", seconds, baseline);
+    std::cout << std::endl;
+
+    const auto maxThreads = default_num_threads();
+    for (size_t numThreads = 1; numThreads <= maxThreads; numThreads <<= 1) {
+        for (auto isNumaLocal : {false, true}) {
+            array = input;
+            seconds = measure_seconds([&]() {
+                parallel_lsd_sort(array.data(), n, numThreads, isNumaLocal);
+            });
+            if (array != sorted) {
+                fail("parallel_lsd_sort: wrong order");
+            }
+            print_result("parallel_lsd_sort, threads = " + std::to_string(numThreads) +
+                         (isNumaLocal ? ", numa" : ""), seconds, baseline);
+            std::cout << std::endl;
+        }
+    }
+}
+
+// Ширина разряда и способ переноса по размерам от L2 до основной памяти.
+void benchmark_radix_config(size_t maxLength) {
+    const std::pair<RadixScatter, std::string> SCATTERS[] = {
+        {RadixScatter::DIRECT, "direct"},
+        {RadixScatter::BUFFERED, "buffered"},
+        {RadixScatter::STREAMING, "streaming"}
+    };
+
+    for (size_t n = 100000; n <= maxLength; n *= 10) {
+        const auto input = make_random_array(n, 64);
+
+        std::cout << "--- n = " << n << ", lsd_sort digit width and scatter ---" << std::endl;
+
+        auto sorted = input;
+        const auto baseline = measure_seconds([&]() {
+            lsd_sort(sorted.data(), n);
+        });
+        print_result("lsd_sort (auto)", baseline, baseline);
+        std::cout << std::endl;
+
+        for (unsigned digitBits : {8, 11, 16}) {
+            for (const auto &scatter : SCATTERS) {
+                radix_config_t config;
+                config.digitBits = digitBits;
+                config.scatter = scatter.first;
+
+                auto array = input;
+                const auto seconds = measure_seconds([&]() {
+                    lsd_sort_by_key(array.data(), n, radix_identity(), config);
+                });
+                if (array != sorted) {
+                    fail("lsd_sort_by_key: wrong order");
+                }
+                print_result(std::to_string(digitBits) + " bits, " + scatter.second, seconds, baseline);
+                std::cout << std::endl;
+            }
+        }
+    }
+}
+
+typedef struct {
+    int64_t key;
+    uint64_t payload;
+} record_t;
+
+template <typename K>
+void benchmark_typed_keys(const std::vector<K> &input, const std::string &keyName) {
+    const auto n = input.size();
+
+    std::cout << "--- n = " << n << ", " << keyName << " keys ---" << std::endl;
+
+    auto sorted = input;
+    const auto baseline = measure_seconds([&]() {
+        std::sort(sorted.begin(), sorted.end());
+    });
+    print_result("std::sort", baseline, baseline);
+    std::cout << std::endl;
+
+    auto array = input;
+    const auto seconds = measure_seconds([&]() {
+        lsd_sort(array.data(), n);
+    });
+    if (array != sorted) {
+        fail("lsd_sort: wrong order");
+    }
+    print_result("lsd_sort", seconds, baseline);
+    std::cout << std::endl;
+}
+
+void benchmark_records(size_t n) {
+    std::mt19937_64 generator(42);
+    std::vector<record_t> input(n);
+    for (size_t i = 0; i < n; ++i) {
+        input[i] = {static_cast<int64_t>(generator()) >> 24, i};
+    }
+    auto less = [](const record_t &left, const record_t &right) {
+        return left.key < right.key;
+    };
+
+    std::cout << "--- n = " << n << ", records with int64_t keys ---" << std::endl;
+
+    auto sorted = input;
+    const auto baseline = measure_seconds([&]() {
+        std::stable_sort(sorted.begin(), sorted.end(), less);
+    });
+    print_result("std::stable_sort", baseline, baseline);
+    std::cout << std::endl;
+
+    auto array = input;
+    auto seconds = measure_seconds([&]() {
+        lsd_sort_by_key(array.data(), n, [](const record_t &record) {
+            return record.key;
+        });
+    });
+    for (size_t i = 0; i < n; ++i) {
+        if (array[i].payload != sorted[i].payload) {
+            fail("lsd_sort_by_key: wrong order");
+        }
+    }
+    print_result("lsd_sort_by_key", seconds, baseline);
+    std::cout << std::endl;
+
+    std::vector<int64_t> keys(n);
+    std::transform(input.begin(), input.end(), keys.begin(), [](const record_t &record) {
+        return record.key;
+    });
+    std::vector<uint32_t> indices(n);
+    seconds = measure_seconds([&]() {
+        radix_argsort(keys.data(), n, indices.data());
+    });
+    for (size_t i = 0; i < n; ++i) {
+        if (indices[i] != sorted[i].payload) {
+            fail("radix_argsort: wrong order");
+        }
+    }
+    print_result("radix_argsort", seconds, baseline);
+    std::cout << std::endl;
+}
+
+// URL с длинными общими префиксами: хост и путь каталога повторяются,
+// различаются категория, номер товара и параметры запроса.
+std::vector<std::string> make_urls(size_t n) {
+    const std::string HOSTS[] = {
+        "https://www.example.com/catalog/",
+        "https://shop.example.com/catalog/products/",
+        "https://static.example.org/assets/images/"
+    };
+    std::mt19937_64 generator(42);
+
+    std::vector<std::string> urls(n);
+    for (auto &url : urls) {
+        url = HOSTS[generator() % 3] + "category-" + std::to_string(generator() % 50) + "/item-" +
+              std::to_string(generator() % 1000000);
+        if (generator() % 2) {
+            url += "?utm_source=newsletter&utm_medium=email&session=" + std::to_string(generator() % 100000);
+        }
+    }
+    return urls;
+}
+
+void benchmark_strings(size_t n) {
+    const auto input = make_urls(n);
+
+    std::cout << "--- n = " << n << ", URL-like strings ---" << std::endl;
+
+    auto sorted = input;
+    const auto baseline = measure_seconds([&]() {
+        std::sort(sorted.begin(), sorted.end());
+    });
+    print_result("std::sort", baseline, baseline);
+    std::cout << std::endl;
+
+    auto array = input;
+    auto seconds = measure_seconds([&]() {
+        string_msd_sort(array.data(), n);
+    });
+    if (array != sorted) {
+        fail("string_msd_sort: wrong order");
+    }
+    print_result("string_msd_sort", seconds, baseline);
+    std::cout << std::endl;
+
+    std::vector<const std::string*> pointers(n);
+    for (size_t i = 0; i < n; ++i) {
+        pointers[i] = &input[i];
+    }
+    seconds = measure_seconds([&]() {
+        string_msd_sort(pointers.data(), n);
+    });
+    for (size_t i = 0; i < n; ++i) {
+        if (*pointers[i] != sorted[i]) {
+            fail("string_msd_sort: wrong order");
+        }
+    }
+    print_result("string_msd_sort (pointers)", seconds, baseline);
+    std::cout << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_BENCHMARK_LENGTH;
+    if (!n) {
+        fail("n should be greater than 0");
+    }
+
+    benchmark_lsd_sort(n, 64);
+    benchmark_lsd_sort(n, 40);
+    benchmark_radix_config(n);
+
+    std::mt19937_64 generator(42);
+    std::vector<int64_t> signedKeys(n);
+    std::vector<double> doubleKeys(n);
+    for (size_t i = 0; i < n; ++i) {
+        signedKeys[i] = static_cast<int64_t>(generator());
+        doubleKeys[i] = std::normal_distribution<double>()(generator);
+    }
+    benchmark_typed_keys(signedKeys, "int64_t");
+    benchmark_typed_keys(doubleKeys, "double");
+    benchmark_records(n);
+    benchmark_strings(std::min<size_t>(n, STRING_BENCHMARK_MAX_LENGTH));
+
+    return 0;
+}
@@ -5,15 +5,11 @@
  */
 
 #include <iostream>
-#include <cassert>
-#include <cstring>
+#include "radix_sort.h"
 
 #define PRINT_ERROR(err_msg) \
     std::cerr << (err_msg);
 
-template <typename T>
-void lsd_sort(T *array, size_t n);
-
 int main() {
     uint64_t *numbers = nullptr;
 
@@ -51,45 +47,3 @@ int main() {
 
     return 0;
 }
-
-#define BITS_IN_BYTE 256
-
-template <typename T>
-inline uint8_t get_byte(const T &x, uint8_t k) {
-    return (uint8_t)(x >> (k << 3));
-}
-
-template <typename T>
-void lsd_sort(T *array, size_t n) {
-    assert(array && n > 0);
-
-    size_t numBits = sizeof(uint8_t) * BITS_IN_BYTE;
-
-    auto count = new size_t[numBits];
-    auto tempArray = new T[n];
-
-    for (uint8_t k = 0; k < sizeof(T); ++k) {
-        memset(count, 0, numBits * sizeof(size_t));
-
-        for (size_t i = 0; i < n; ++i) {
-            auto b = get_byte(array[i], k);
-            ++count[b];
-        }
-
-        for (size_t i = 1; i < numBits; ++i) {
-            count[i] += count[i - 1];
-        }
-
-        size_t lastIndex = n - 1;
-        for (size_t i = 0; i < n; ++i) {
-            auto b = get_byte(array[lastIndex - i], k);
-            --count[b];
-            tempArray[count[b]] = array[lastIndex - i];
-        }
-
-        memcpy(array, tempArray, n * sizeof(T));
-    }
-
-    delete[] tempArray;
-    delete[] count;
-}
\ No newline at end of file
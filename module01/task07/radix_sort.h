@@ -0,0 +1,134 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#define BITS_IN_BYTE 256
+#define PARALLEL_RADIX_MIN_SLICE (1 << 16)
+#define MSD_INSERTION_MAX_LENGTH 64
+
+#define RADIX_CACHE_LINE 64
+#define RADIX_DEFAULT_L2_CACHE_SIZE (256 << 10)
+
+// Отображение ключа в беззнаковое целое той же ширины, сохраняющее порядок:
+// у знаковых целых инвертируется знаковый бит, у чисел с плавающей точкой
+// отрицательные инвертируются целиком, а у положительных - только знаковый
+// бит (-0.0 идёт раньше +0.0, NaN - по краям в зависимости от знака).
+// Число проходов сортировки равно sizeof(bits_t). Целые типы выбираются по
+// знаковости, а не по именам из <cstdint>: long long и long на LP64 - разные типы.
+template <typename K, typename Enable = void>
+struct radix_key_traits;
+
+template <typename U>
+struct unsigned_radix_traits {
+    typedef U bits_t;
+
+    static bits_t ToBits(U key) {
+        return key;
+    }
+};
+
+template <typename S, typename U>
+struct signed_radix_traits {
+    typedef U bits_t;
+
+    static bits_t ToBits(S key) {
+        return static_cast<U>(key) ^ (U(1) << (8 * sizeof(U) - 1));
+    }
+};
+
+template <typename F, typename U>
+struct floating_radix_traits {
+    typedef U bits_t;
+
+    static bits_t ToBits(F key) {
+        U bits;
+        memcpy(&bits, &key, sizeof(bits));
+        const U signBit = U(1) << (8 * sizeof(U) - 1);
+        return bits ^ ((bits & signBit) ? ~U(0) : signBit);
+    }
+};
+
+template <typename K>
+struct radix_key_traits<K, typename std::enable_if<std::is_integral<K>::value && std::is_unsigned<K>::value &&
+        !std::is_same<K, bool>::value>::type> : unsigned_radix_traits<K> {};
+template <typename K>
+struct radix_key_traits<K, typename std::enable_if<std::is_integral<K>::value && std::is_signed<K>::value>::type>
+        : signed_radix_traits<K, typename std::make_unsigned<K>::type> {};
+template <> struct radix_key_traits<float> : floating_radix_traits<float, uint32_t> {};
+template <> struct radix_key_traits<double> : floating_radix_traits<double, uint64_t> {};
+
+struct radix_identity {
+    template <typename T>
+    const T &operator()(const T &item) const {
+        return item;
+    }
+};
+
+enum class RadixScatter {
+    AUTO,
+    // Запись сразу в массив назначения.
+    DIRECT,
+    // Запись через буфер размером в строку кэша на корзину; полные строки
+    // переносятся целиком (software write-combining).
+    BUFFERED,
+    // То же, но полные строки пишутся потоковыми записями в обход кэша.
+    STREAMING
+};
+
+typedef struct {
+    // Ширина разряда: 8, 11 или 16 бит; 0 - по n и размерам кэшей.
+    unsigned digitBits = 0;
+    RadixScatter scatter = RadixScatter::AUTO;
+} radix_config_t;
+
+// Поразрядная сортировка LSD для целых и чисел с плавающей точкой.
+template <typename T>
+void lsd_sort(T *array, size_t n);
+
+// Устойчивая LSD-сортировка записей по ключу keyOf(item); записи переносятся
+// целиком. Тип ключа - любой, для которого есть radix_key_traits.
+template <typename T, typename KeyOf>
+void lsd_sort_by_key(T *array, size_t n, KeyOf keyOf, const radix_config_t &config = radix_config_t());
+
+// Ширина разряда для n элементов размера itemSize с ключом из keySize байтов:
+// широкий разряд сокращает число проходов, но его гистограмма и буферы
+// корзин должны помещаться в L2. Способ переноса выбирается по тому, помещается
+// ли массив в L2.
+inline unsigned choose_radix_digit_bits(size_t n, size_t keySize, size_t itemSize);
+inline RadixScatter choose_radix_scatter(size_t n, size_t itemSize, unsigned digitBits);
+
+// indices - перестановка 0..n-1, упорядочивающая keys; при равных ключах
+// индексы идут по возрастанию.
+template <typename K, typename I>
+void radix_argsort(const K *keys, size_t n, I *indices);
+
+// Параллельная LSD для беззнаковых целых: каждый поток строит гистограммы
+// своей части массива, общая префиксная сумма по (байт, поток) даёт каждому
+// потоку его смещения в корзинах, и поток переносит свою часть устойчиво -
+// результат совпадает с lsd_sort. numThreads = 0 - по числу ядер.
+// isNumaLocal: буфер заполняется впервые теми же потоками, что читают
+// соответствующие части, чтобы страницы оказались в их узлах памяти.
+template <typename T>
+void parallel_lsd_sort(T *array, size_t n, size_t numThreads = 0, bool isNumaLocal = false);
+
+// Поразрядная сортировка MSD на месте (American flag sort) для беззнаковых
+// целых: корзины старшего байта раскладываются циклами перестановок без
+// второго массива, затем каждая корзина сортируется по следующему байту.
+// Корзины не длиннее MSD_INSERTION_MAX_LENGTH досортировываются вставками.
+// Дополнительная память - O(BITS_IN_BYTE) на уровень, уровней не больше sizeof(T).
+template <typename T>
+void msd_sort(T *array, size_t n);
+
+template <typename T>
+void msd_sort_range(T *array, size_t firstIndex, size_t lastIndex, uint8_t k);
+
+template <typename T>
+uint8_t get_byte(const T &x, uint8_t k);
+
+#include "radix_sort.hpp"
+
+#endif //RADIX_SORT_H
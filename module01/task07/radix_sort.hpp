@@ -0,0 +1,479 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+template <typename T>
+inline uint8_t get_byte(const T &x, uint8_t k) {
+    return (uint8_t)(x >> (k << 3));
+}
+
+template <typename T>
+void lsd_sort(T *array, size_t n) {
+    lsd_sort_by_key(array, n, radix_identity());
+}
+
+inline size_t get_l2_cache_size() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    static const auto size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (size > 0) {
+        return static_cast<size_t>(size);
+    }
+#endif
+    return RADIX_DEFAULT_L2_CACHE_SIZE;
+}
+
+inline unsigned choose_radix_digit_bits(size_t n, size_t keySize, size_t itemSize) {
+    const auto l2CacheSize = get_l2_cache_size();
+    const size_t keyBits = 8 * keySize;
+
+    // 11-битный разряд выгоден, только если проходов становится меньше,
+    // массив не помещается в L2, а счётчики и буферы 2048 корзин занимают
+    // не больше его половины. 16-битный не выбирается никогда: запись
+    // в 65536 корзин промахивается мимо кэша и TLB почти на каждом элементе,
+    // и даже для 32-битных ключей два прохода медленнее трёх 11-битных.
+    const size_t wideBuckets = size_t(1) << 11;
+    const bool hasFewerPasses = (keyBits + 10) / 11 < keySize;
+    const bool fitsCache = wideBuckets * (RADIX_CACHE_LINE + sizeof(size_t)) <= l2CacheSize / 2;
+    if (hasFewerPasses && fitsCache && n * itemSize > l2CacheSize) {
+        return 11;
+    }
+    return 8;
+}
+
+inline RadixScatter choose_radix_scatter(size_t n, size_t itemSize, unsigned digitBits) {
+    if (RADIX_CACHE_LINE % itemSize || itemSize > RADIX_CACHE_LINE / 2 || digitBits > 11) {
+        return RadixScatter::DIRECT;
+    }
+    // Пока массив в L2, прямые записи дешевле копирования через буферы.
+    // Больше - потоковые записи полных строк: не нужно читать строку
+    // назначения перед записью, и массив не вытесняет из кэша счётчики.
+    return n * itemSize > get_l2_cache_size() ? RadixScatter::STREAMING : RadixScatter::DIRECT;
+}
+
+template <unsigned DIGIT_BITS, typename B>
+inline size_t get_digit(B bits, unsigned d) {
+    return static_cast<size_t>((bits >> (d * DIGIT_BITS)) & ((B(1) << DIGIT_BITS) - 1));
+}
+
+template <typename T, typename DigitOf>
+void radix_scatter_direct(const T *source, size_t n, T *target, size_t *offsets, DigitOf digitOf) {
+    for (size_t i = 0; i < n; ++i) {
+        target[offsets[digitOf(source[i])]++] = source[i];
+    }
+}
+
+// Полная строка кэша из буфера корзины в выровненный адрес массива.
+template <typename T>
+inline void radix_flush_line(T *target, const T *line, bool isStreaming) {
+#ifdef __SSE2__
+    if (isStreaming) {
+        auto from = reinterpret_cast<const __m128i*>(line);
+        auto to = reinterpret_cast<__m128i*>(target);
+        for (size_t i = 0; i < RADIX_CACHE_LINE / sizeof(__m128i); ++i) {
+            _mm_stream_si128(to + i, _mm_load_si128(from + i));
+        }
+        return;
+    }
+#else
+    (void)isStreaming;
+#endif
+    memcpy(target, line, RADIX_CACHE_LINE);
+}
+
+// Элементы копятся в буфере корзины с тем же сдвигом внутри строки, что и
+// их места в target. Заполненная строка переносится целиком, поэтому
+// в память уходят полные выровненные строки, а не 2^DIGIT_BITS потоков
+// одиночных записей. Неполные строки на границах корзин копируются поэлементно.
+template <typename T, typename DigitOf>
+void radix_scatter_buffered(const T *source, size_t n, T *target, size_t *offsets, size_t numBuckets,
+                            DigitOf digitOf, T *lines, size_t *bucketStarts, bool isStreaming) {
+    const size_t lineLength = RADIX_CACHE_LINE / sizeof(T);
+    const auto phase = (reinterpret_cast<uintptr_t>(target) / sizeof(T)) & (lineLength - 1);
+
+    std::copy(offsets, offsets + numBuckets, bucketStarts);
+
+    for (size_t i = 0; i < n; ++i) {
+        const auto b = digitOf(source[i]);
+        const auto position = offsets[b]++;
+        const auto slot = (position + phase) & (lineLength - 1);
+        auto line = lines + b * lineLength;
+        line[slot] = source[i];
+
+        if (slot == lineLength - 1) {
+            if (position + 1 >= bucketStarts[b] + lineLength) {
+                radix_flush_line(target + position + 1 - lineLength, line, isStreaming);
+            }
+            else {
+                const auto length = position + 1 - bucketStarts[b];
+                memcpy(target + bucketStarts[b], line + lineLength - length, length * sizeof(T));
+            }
+        }
+    }
+
+    for (size_t b = 0; b < numBuckets; ++b) {
+        const auto end = offsets[b];
+        const auto tailLength = std::min((end + phase) & (lineLength - 1), end - bucketStarts[b]);
+        const auto lineStart = end - tailLength;
+        if (tailLength > 0) {
+            const auto slot = (lineStart + phase) & (lineLength - 1);
+            memcpy(target + lineStart, lines + b * lineLength + slot, (end - lineStart) * sizeof(T));
+        }
+    }
+
+#ifdef __SSE2__
+    if (isStreaming) {
+        _mm_sfence();
+    }
+#endif
+}
+
+// Гистограммы всех разрядов строятся за один проход. Разряд, одинаковый у всех
+// ключей (одна непустая корзина), пропускается. Проходы чередуют массив и
+// буфер, поэтому копирование нужно не больше одного раза в конце. Перенос
+// идёт от начала к концу, чтобы аппаратная предвыборка работала на чтении.
+template <unsigned DIGIT_BITS, typename T, typename KeyOf>
+void lsd_sort_by_digits(T *array, size_t n, KeyOf keyOf, RadixScatter scatter) {
+    typedef typename std::decay<decltype(keyOf(*array))>::type key_t;
+    typedef radix_key_traits<key_t> traits;
+    typedef typename traits::bits_t bits_t;
+
+    const size_t numBuckets = size_t(1) << DIGIT_BITS;
+    const unsigned numDigits = (8 * sizeof(bits_t) + DIGIT_BITS - 1) / DIGIT_BITS;
+
+    auto digit_of = [&keyOf](const T &item, unsigned d) {
+        return get_digit<DIGIT_BITS>(traits::ToBits(keyOf(item)), d);
+    };
+
+    auto counts = new size_t[numDigits * numBuckets]();
+    for (size_t i = 0; i < n; ++i) {
+        const auto bits = traits::ToBits(keyOf(array[i]));
+        for (unsigned d = 0; d < numDigits; ++d) {
+            ++counts[d * numBuckets + get_digit<DIGIT_BITS>(bits, d)];
+        }
+    }
+
+    auto tempArray = new T[n];
+    auto source = array;
+    auto target = tempArray;
+
+    // Буферы корзин выровнены по строке кэша.
+    char *lineStorage = nullptr;
+    T *lines = nullptr;
+    std::vector<size_t> bucketStarts;
+    if (scatter != RadixScatter::DIRECT) {
+        lineStorage = new char[numBuckets * RADIX_CACHE_LINE + RADIX_CACHE_LINE];
+        const auto address = reinterpret_cast<uintptr_t>(lineStorage);
+        lines = reinterpret_cast<T*>(lineStorage + (RADIX_CACHE_LINE - address % RADIX_CACHE_LINE) % RADIX_CACHE_LINE);
+        bucketStarts.resize(numBuckets);
+    }
+
+    for (unsigned d = 0; d < numDigits; ++d) {
+        auto count = counts + d * numBuckets;
+        if (count[digit_of(source[0], d)] == n) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t b = 0; b < numBuckets; ++b) {
+            const auto bucketLength = count[b];
+            count[b] = offset;
+            offset += bucketLength;
+        }
+
+        auto digitOf = [&digit_of, d](const T &item) {
+            return digit_of(item, d);
+        };
+        // Для выровненных строк адрес массива должен быть кратен размеру элемента.
+        if (scatter == RadixScatter::DIRECT || reinterpret_cast<uintptr_t>(target) % sizeof(T)) {
+            radix_scatter_direct(source, n, target, count, digitOf);
+        }
+        else {
+            radix_scatter_buffered(source, n, target, count, numBuckets, digitOf, lines, bucketStarts.data(),
+                                   scatter == RadixScatter::STREAMING);
+        }
+
+        std::swap(source, target);
+    }
+
+    if (source != array) {
+        std::copy(source, source + n, array);
+    }
+
+    delete[] lineStorage;
+    delete[] tempArray;
+    delete[] counts;
+}
+
+template <typename T, typename KeyOf>
+void lsd_sort_by_key(T *array, size_t n, KeyOf keyOf, const radix_config_t &config) {
+    assert(array && n > 0);
+
+    typedef typename std::decay<decltype(keyOf(*array))>::type key_t;
+    typedef typename radix_key_traits<key_t>::bits_t bits_t;
+
+    auto digitBits = config.digitBits ? config.digitBits : choose_radix_digit_bits(n, sizeof(bits_t), sizeof(T));
+    auto scatter = config.scatter;
+    if (scatter == RadixScatter::AUTO) {
+        scatter = choose_radix_scatter(n, sizeof(T), digitBits);
+    }
+    // Буферизация строк только для элементов, которые можно копировать побайтно.
+    if (!std::is_trivially_copyable<T>::value || RADIX_CACHE_LINE % sizeof(T) || sizeof(T) > RADIX_CACHE_LINE / 2) {
+        scatter = RadixScatter::DIRECT;
+    }
+
+    switch (digitBits) {
+        case 8:
+            lsd_sort_by_digits<8>(array, n, keyOf, scatter);
+            break;
+
+        case 11:
+            lsd_sort_by_digits<11>(array, n, keyOf, scatter);
+            break;
+
+        case 16:
+            lsd_sort_by_digits<16>(array, n, keyOf, scatter);
+            break;
+
+        default:
+            assert(false);
+    }
+}
+
+template <typename K, typename I>
+void radix_argsort(const K *keys, size_t n, I *indices) {
+    assert(keys && indices && n > 0);
+
+    typedef typename radix_key_traits<K>::bits_t bits_t;
+    typedef struct {
+        bits_t key;
+        I index;
+    } keyed_index_t;
+
+    // Ключи переносятся вместе с индексами, чтобы не читать keys вразброс.
+    std::vector<keyed_index_t> keyedIndices(n);
+    for (size_t i = 0; i < n; ++i) {
+        keyedIndices[i] = {radix_key_traits<K>::ToBits(keys[i]), static_cast<I>(i)};
+    }
+
+    lsd_sort_by_key(keyedIndices.data(), n, [](const keyed_index_t &item) {
+        return item.key;
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+        indices[i] = keyedIndices[i].index;
+    }
+}
+
+template <typename T>
+void msd_sort(T *array, size_t n) {
+    static_assert(std::is_unsigned<T>::value, "msd_sort: unsigned keys only");
+    assert(array && n > 0);
+    msd_sort_range(array, 0, n, sizeof(T) - 1);
+}
+
+// Сортирует [firstIndex, lastIndex) по байтам k, k - 1, ..., 0.
+template <typename T>
+void msd_sort_range(T *array, size_t firstIndex, size_t lastIndex, uint8_t k) {
+    const size_t numBits = sizeof(uint8_t) * BITS_IN_BYTE;
+    size_t count[numBits];
+    size_t heads[numBits];
+    size_t tails[numBits];
+
+    while (true) {
+        const auto length = lastIndex - firstIndex;
+        if (length <= MSD_INSERTION_MAX_LENGTH) {
+            for (auto i = firstIndex + 1; i < lastIndex; ++i) {
+                for (auto j = i; j > firstIndex && array[j] < array[j - 1]; --j) {
+                    std::swap(array[j], array[j - 1]);
+                }
+            }
+            return;
+        }
+
+        std::fill(count, count + numBits, 0);
+        for (auto i = firstIndex; i < lastIndex; ++i) {
+            ++count[get_byte(array[i], k)];
+        }
+
+        // Байт одинаков во всём диапазоне - сразу к следующему.
+        if (count[get_byte(array[firstIndex], k)] == length) {
+            if (!k) {
+                return;
+            }
+            --k;
+            continue;
+        }
+        break;
+    }
+
+    auto offset = firstIndex;
+    for (size_t b = 0; b < numBits; ++b) {
+        heads[b] = offset;
+        offset += count[b];
+        tails[b] = offset;
+    }
+
+    // Элемент переносится в голову своей корзины, вытесненный элемент - дальше
+    // по циклу, пока в текущую позицию не придёт элемент этой корзины.
+    for (size_t b = 0; b < numBits; ++b) {
+        while (heads[b] < tails[b]) {
+            auto item = array[heads[b]];
+            auto d = get_byte(item, k);
+            while (d != b) {
+                std::swap(item, array[heads[d]++]);
+                d = get_byte(item, k);
+            }
+            array[heads[b]++] = item;
+        }
+    }
+
+    if (!k) {
+        return;
+    }
+    auto bucketFirst = firstIndex;
+    for (size_t b = 0; b < numBits; ++b) {
+        if (count[b] > 1) {
+            msd_sort_range(array, bucketFirst, bucketFirst + count[b], static_cast<uint8_t>(k - 1));
+        }
+        bucketFirst += count[b];
+    }
+}
+
+// Та же пара, что в task05/sort.h и task06/parallel_partition.hpp (задачи собираются
+// отдельно); бенчмарк task05 подключает этот файл вместе с sort.h, поэтому копии
+// закрыты общим макросом.
+#ifndef RUN_IN_PARALLEL_DEFINED
+#define RUN_IN_PARALLEL_DEFINED
+
+template <typename F>
+void run_in_parallel(size_t numThreads, F &&task) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (size_t t = 1; t < numThreads; ++t) {
+        threads.emplace_back(task, t);
+    }
+    task(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+inline size_t default_num_threads() {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+#endif //RUN_IN_PARALLEL_DEFINED
+
+template <typename T>
+void parallel_lsd_sort(T *array, size_t n, size_t numThreads, bool isNumaLocal) {
+    static_assert(std::is_unsigned<T>::value, "parallel_lsd_sort: unsigned keys only");
+    assert(array && n > 0);
+
+    if (!numThreads) {
+        numThreads = default_num_threads();
+    }
+    numThreads = std::min(numThreads, std::max<size_t>(n / PARALLEL_RADIX_MIN_SLICE, 1));
+    if (numThreads == 1) {
+        lsd_sort(array, n);
+        return;
+    }
+
+    const size_t numBits = sizeof(uint8_t) * BITS_IN_BYTE;
+    const size_t numDigits = sizeof(T);
+
+    // Часть потока t - [first(t), first(t + 1)); на всех проходах одна и та же.
+    auto first = [n, numThreads](size_t t) {
+        return t * n / numThreads;
+    };
+
+    // Гистограмма байта k части потока t.
+    std::vector<size_t> counts(numThreads * numDigits * numBits);
+    auto count_of = [&counts, numDigits, numBits](size_t t, size_t k) {
+        return counts.data() + (t * numDigits + k) * numBits;
+    };
+
+    auto tempArray = new T[n];
+
+    run_in_parallel(numThreads, [&](size_t t) {
+        for (auto i = first(t); i < first(t + 1); ++i) {
+            for (uint8_t k = 0; k < numDigits; ++k) {
+                ++count_of(t, k)[get_byte(array[i], k)];
+            }
+        }
+        if (isNumaLocal) {
+            memset(tempArray + first(t), 0, (first(t + 1) - first(t)) * sizeof(T));
+        }
+    });
+
+    auto source = array;
+    auto target = tempArray;
+    std::vector<size_t> offsets(numThreads * numBits);
+    bool isPermuted = false;
+
+    for (uint8_t k = 0; k < numDigits; ++k) {
+        // Общая гистограмма байта не зависит от перестановки, поэтому пропуск
+        // решается по начальным гистограммам.
+        size_t numNonEmpty = 0;
+        for (size_t b = 0; b < numBits && numNonEmpty < 2; ++b) {
+            size_t total = 0;
+            for (size_t t = 0; t < numThreads; ++t) {
+                total += count_of(t, k)[b];
+            }
+            numNonEmpty += total > 0;
+        }
+        if (numNonEmpty < 2) {
+            continue;
+        }
+
+        // Начальные гистограммы частей верны только до первого переноса.
+        if (isPermuted) {
+            run_in_parallel(numThreads, [&](size_t t) {
+                auto count = count_of(t, k);
+                std::fill(count, count + numBits, 0);
+                for (auto i = first(t); i < first(t + 1); ++i) {
+                    ++count[get_byte(source[i], k)];
+                }
+            });
+        }
+
+        size_t offset = 0;
+        for (size_t b = 0; b < numBits; ++b) {
+            for (size_t t = 0; t < numThreads; ++t) {
+                offsets[t * numBits + b] = offset;
+                offset += count_of(t, k)[b];
+            }
+        }
+
+        run_in_parallel(numThreads, [&](size_t t) {
+            auto offset = offsets.data() + t * numBits;
+            for (auto i = first(t); i < first(t + 1); ++i) {
+                target[offset[get_byte(source[i], k)]++] = source[i];
+            }
+        });
+
+        std::swap(source, target);
+        isPermuted = true;
+    }
+
+    if (source != array) {
+        run_in_parallel(numThreads, [&](size_t t) {
+            memcpy(array + first(t), source + first(t), (first(t + 1) - first(t)) * sizeof(T));
+        });
+    }
+
+    delete[] tempArray;
+}
+
+#endif //RADIX_SORT_HPP
@@ -0,0 +1,29 @@
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "radix_sort.h"
+
+#define STRING_INSERTION_MAX_LENGTH 32
+// Корзина 0 - строки, закончившиеся до текущей позиции, 1..256 - байты 0..255.
+#define STRING_BUCKETS (BITS_IN_BYTE + 1)
+
+// Поразрядная сортировка MSD строк в лексикографическом порядке std::string.
+// На каждом уровне символ позиции depth читается из строки один раз и
+// кэшируется в массиве рядом с указателями: подсчёт и перенос идут по кэшу,
+// а не по разбросанным в памяти строкам. Общий префикс всех строк корзины
+// пропускается без переноса, корзины не длиннее STRING_INSERTION_MAX_LENGTH
+// досортировываются вставками со сравнением от позиции depth.
+inline void string_msd_sort(std::string *array, size_t n);
+
+// То же для указателей: строки не перемещаются.
+inline void string_msd_sort(const std::string **array, size_t n);
+
+inline uint16_t get_string_char(const std::string &s, size_t depth);
+
+#include "string_sort.hpp"
+
+#endif //STRING_SORT_H
@@ -0,0 +1,124 @@
+#ifndef STRING_SORT_HPP
+#define STRING_SORT_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+typedef struct {
+    size_t firstIndex;
+    size_t lastIndex;
+    size_t depth;
+} string_range_t;
+
+inline uint16_t get_string_char(const std::string &s, size_t depth) {
+    return depth < s.size() ? static_cast<uint16_t>(static_cast<uint8_t>(s[depth]) + 1) : 0;
+}
+
+// Первые depth символов у всех строк диапазона совпадают.
+inline void string_insertion_sort(const std::string **array, size_t firstIndex, size_t lastIndex, size_t depth) {
+    for (auto i = firstIndex + 1; i < lastIndex; ++i) {
+        for (auto j = i; j > firstIndex && array[j]->compare(depth, std::string::npos, *array[j - 1], depth,
+                                                             std::string::npos) < 0; --j) {
+            std::swap(array[j], array[j - 1]);
+        }
+    }
+}
+
+// Длина общего префикса строк диапазона, начиная с позиции depth.
+inline size_t get_common_prefix_length(const std::string **array, size_t firstIndex, size_t lastIndex,
+                                       size_t depth) {
+    const auto &first = *array[firstIndex];
+    size_t length = first.size() > depth ? first.size() - depth : 0;
+    for (auto i = firstIndex + 1; i < lastIndex && length > 0; ++i) {
+        const auto &s = *array[i];
+        const auto maxLength = std::min(length, s.size() > depth ? s.size() - depth : 0);
+        const auto mismatch = std::mismatch(first.data() + depth, first.data() + depth + maxLength,
+                                            s.data() + depth);
+        length = static_cast<size_t>(mismatch.first - (first.data() + depth));
+    }
+    return length;
+}
+
+inline void string_msd_sort(const std::string **array, size_t n) {
+    assert(array && n > 0);
+
+    std::vector<uint16_t> cache(n);
+    std::vector<const std::string*> tempArray(n);
+    size_t count[STRING_BUCKETS];
+
+    // Явный стек: глубина рекурсии росла бы с длиной строк.
+    std::vector<string_range_t> stack = {{0, n, 0}};
+    while (!stack.empty()) {
+        const auto range = stack.back();
+        stack.pop_back();
+
+        const auto firstIndex = range.firstIndex;
+        const auto lastIndex = range.lastIndex;
+        const auto length = lastIndex - firstIndex;
+        auto depth = range.depth;
+        if (length <= STRING_INSERTION_MAX_LENGTH) {
+            string_insertion_sort(array, firstIndex, lastIndex, depth);
+            continue;
+        }
+
+        while (true) {
+            std::fill(count, count + STRING_BUCKETS, 0);
+            for (auto i = firstIndex; i < lastIndex; ++i) {
+                cache[i] = get_string_char(*array[i], depth);
+                ++count[cache[i]];
+            }
+
+            // Символ одинаков во всём диапазоне: общий префикс находится одним
+            // проходом сравнений с первой строкой, и подсчёт повторяется уже за ним.
+            if (cache[firstIndex] && count[cache[firstIndex]] == length) {
+                depth += get_common_prefix_length(array, firstIndex, lastIndex, depth + 1) + 1;
+                continue;
+            }
+            break;
+        }
+        if (count[0] == length) {
+            continue;
+        }
+
+        size_t offsets[STRING_BUCKETS];
+        auto offset = firstIndex;
+        for (size_t b = 0; b < STRING_BUCKETS; ++b) {
+            offsets[b] = offset;
+            offset += count[b];
+        }
+        for (auto i = firstIndex; i < lastIndex; ++i) {
+            tempArray[offsets[cache[i]]++] = array[i];
+        }
+        std::copy(tempArray.begin() + firstIndex, tempArray.begin() + lastIndex, array + firstIndex);
+
+        // Строки корзины 0 закончились и равны между собой.
+        auto bucketFirst = firstIndex + count[0];
+        for (size_t b = 1; b < STRING_BUCKETS; ++b) {
+            if (count[b] > 1) {
+                stack.push_back({bucketFirst, bucketFirst + count[b], depth + 1});
+            }
+            bucketFirst += count[b];
+        }
+    }
+}
+
+inline void string_msd_sort(std::string *array, size_t n) {
+    assert(array && n > 0);
+
+    std::vector<const std::string*> pointers(n);
+    for (size_t i = 0; i < n; ++i) {
+        pointers[i] = array + i;
+    }
+    string_msd_sort(pointers.data(), n);
+
+    std::vector<std::string> sorted;
+    sorted.reserve(n);
+    for (auto pointer : pointers) {
+        sorted.push_back(std::move(array[pointer - array]));
+    }
+    std::move(sorted.begin(), sorted.end(), array);
+}
+
+#endif //STRING_SORT_HPP
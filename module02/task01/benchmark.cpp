@@ -0,0 +1,320 @@
+/* Замеры производительности хеш-таблицы строк.
+ * Запуск: task01_benchmark [n]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <unordered_set>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "hashtable.h"
+#include "robin_hood_hashtable.h"
+#include "concurrent_hashtable.h"
+#include "str_hash.h"
+
+#define DEFAULT_BENCHMARK_LENGTH 10000000
+#define CONCURRENT_BENCHMARK_MAX_KEYS 1000000
+#define CONCURRENT_BENCHMARK_OPERATIONS 4000000
+#define CONCURRENT_BENCHMARK_MAX_THREADS 64
+
+typedef std::vector<std::string> keys_t;
+
+template <typename F>
+double measure_seconds(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void print_result(const std::string &name, size_t n, double seconds) {
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3) << seconds << " s"
+              << std::setw(10) << std::setprecision(1) << seconds * 1e9 / n << " ns/op" << std::endl;
+}
+
+void fail(const std::string &message) {
+    std::cerr << "[" << message << "]" << std::endl;
+    std::exit(1);
+}
+
+// Ключи длиной от 11 до 23 символов: и короткие строки без выделения памяти,
+// и длинные в куче.
+keys_t make_keys(size_t n, uint64_t seed) {
+    std::mt19937_64 generator(seed);
+
+    keys_t keys(n);
+    for (auto &key : keys) {
+        key = "key" + std::to_string(generator() >> (generator() % 40));
+    }
+    return keys;
+}
+
+template <typename Table>
+void benchmark_table(const std::string &name, const keys_t &keys, const keys_t &missingKeys) {
+    const auto n = keys.size();
+
+    std::cout << "--- " << name << ", n = " << n << " ---" << std::endl;
+
+    Table table;
+    size_t numAdded = 0;
+    auto seconds = measure_seconds([&]() {
+        for (const auto &key : keys) {
+            numAdded += table.TryAdd(key);
+        }
+    });
+    if (numAdded != n) {
+        fail(name + ": key not added");
+    }
+    print_result("insert", n, seconds);
+
+    size_t numFound = 0;
+    seconds = measure_seconds([&]() {
+        for (const auto &key : keys) {
+            numFound += table.Has(key);
+        }
+    });
+    if (numFound != n) {
+        fail(name + ": inserted key not found");
+    }
+    print_result("lookup (hit)", n, seconds);
+
+    numFound = 0;
+    seconds = measure_seconds([&]() {
+        for (const auto &key : missingKeys) {
+            numFound += table.Has(key);
+        }
+    });
+    if (numFound != 0) {
+        fail(name + ": missing key found");
+    }
+    print_result("lookup (miss)", n, seconds);
+
+    size_t numDeleted = 0;
+    seconds = measure_seconds([&]() {
+        for (size_t i = 0; i < n; i += 2) {
+            numDeleted += table.TryDelete(keys[i]);
+        }
+    });
+    print_result("delete half", (n + 1) / 2, seconds);
+
+    numFound = 0;
+    for (size_t i = 0; i < n; ++i) {
+        numFound += table.Has(keys[i]) == (i % 2 == 1);
+    }
+    if (numFound != n || numDeleted != (n + 1) / 2) {
+        fail(name + ": wrong contents after delete");
+    }
+}
+
+// Вставка, после которой заполнение превышает maxLoadFactor и буфер из
+// capacity слотов перестраивается в вдвое больший.
+template <typename Table>
+void benchmark_resize(const std::string &name, const keys_t &keys, double maxLoadFactor) {
+    size_t capacity = 1;
+    while (capacity * 2 * maxLoadFactor < keys.size()) {
+        capacity *= 2;
+    }
+    const auto n = static_cast<size_t>(capacity * maxLoadFactor);
+
+    Table table;
+    for (size_t i = 0; i < n; ++i) {
+        table.TryAdd(keys[i]);
+    }
+    const auto seconds = measure_seconds([&]() {
+        table.TryAdd(keys[n]);
+    });
+    print_result(name + ", resize " + std::to_string(capacity), n, seconds);
+}
+
+// Поиск в таблице Робин Гуда при заполнении около 0.45 и около 0.89. Буфер
+// увеличивается вдвое, когда заполнение превышает 0.9, поэтому чуть больше
+// 0.45 * capacity ключей лежат в буфере из capacity слотов наполовину
+// пустом, а 0.89 * capacity - почти полном.
+void benchmark_load_factor(const keys_t &keys, const keys_t &missingKeys) {
+    size_t capacity = 1;
+    while (capacity * 2 * ROBIN_HOOD_MAX_LOAD_FACTOR <= keys.size()) {
+        capacity *= 2;
+    }
+
+    const size_t lengths[] = {
+        static_cast<size_t>(capacity / 2 * ROBIN_HOOD_MAX_LOAD_FACTOR) + 1,
+        static_cast<size_t>(capacity * 0.89)
+    };
+    for (auto n : lengths) {
+        std::cout << "--- RobinHoodHashTable, n = " << n << ", load factor = "
+                  << std::setprecision(2) << (double)n / capacity << " ---" << std::endl;
+
+        RobinHoodHashTable<std::string, StrCmp, StrHash> table;
+        for (size_t i = 0; i < n; ++i) {
+            table.TryAdd(keys[i]);
+        }
+
+        size_t numFound = 0;
+        auto seconds = measure_seconds([&]() {
+            for (size_t i = 0; i < n; ++i) {
+                numFound += table.Has(keys[i]);
+            }
+        });
+        if (numFound != n) {
+            fail("RobinHoodHashTable: inserted key not found");
+        }
+        print_result("lookup (hit)", n, seconds);
+
+        numFound = 0;
+        seconds = measure_seconds([&]() {
+            for (size_t i = 0; i < n; ++i) {
+                numFound += table.Has(missingKeys[i]);
+            }
+        });
+        if (numFound != 0) {
+            fail("RobinHoodHashTable: missing key found");
+        }
+        print_result("lookup (miss)", n, seconds);
+    }
+}
+
+// Та же последовательность операций для std::unordered_set.
+class StdTable {
+public:
+    bool TryAdd(const std::string &item) {
+        return set.insert(item).second;
+    }
+
+    bool TryDelete(const std::string &item) {
+        return set.erase(item) > 0;
+    }
+
+    bool Has(const std::string &item) const {
+        return set.count(item) > 0;
+    }
+
+private:
+    std::unordered_set<std::string> set;
+};
+
+// HashTable под одним мьютексом - то, как таблица разделяется между потоками сейчас.
+class LockedHashTable {
+public:
+    bool TryAdd(const std::string &item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return table.TryAdd(item);
+    }
+
+    bool TryDelete(const std::string &item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return table.TryDelete(item);
+    }
+
+    bool Has(const std::string &item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return table.Has(item);
+    }
+
+private:
+    std::mutex mutex;
+    HashTable<std::string, StrCmp, StrHash> table;
+};
+
+// CONCURRENT_BENCHMARK_OPERATIONS операций, поровну между потоками: доля
+// readPercent - поиск, остальные - поочерёдно вставка и удаление случайного
+// ключа, так что размер таблицы остаётся около половины ключей.
+// Последнюю восьмую часть ключей потоки только ищут: чётные из них вставлены
+// заранее, и ответ Has для них известен и во время работы, и после неё.
+template <typename Table>
+void benchmark_concurrent(const std::string &name, const keys_t &keys, size_t readPercent) {
+    const auto firstControl = keys.size() - keys.size() / 8;
+    for (size_t numThreads = 1; numThreads <= CONCURRENT_BENCHMARK_MAX_THREADS; numThreads *= 2) {
+        Table table;
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            table.TryAdd(keys[i]);
+        }
+
+        const auto numOperations = CONCURRENT_BENCHMARK_OPERATIONS / numThreads;
+        std::atomic<size_t> totalWrong{0};
+        std::vector<std::thread> threads;
+        const auto seconds = measure_seconds([&]() {
+            for (size_t t = 0; t < numThreads; ++t) {
+                threads.emplace_back([&, t]() {
+                    std::mt19937_64 generator(t);
+                    size_t numWrong = 0;
+                    for (size_t i = 0; i < numOperations; ++i) {
+                        if (generator() % 100 < readPercent) {
+                            const auto k = generator() % keys.size();
+                            const auto isFound = table.Has(keys[k]);
+                            numWrong += k >= firstControl && isFound != (k % 2 == 0);
+                        }
+                        else if (i % 2) {
+                            table.TryAdd(keys[generator() % firstControl]);
+                        }
+                        else {
+                            table.TryDelete(keys[generator() % firstControl]);
+                        }
+                    }
+                    totalWrong += numWrong;
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+        });
+
+        for (auto k = firstControl; k < keys.size(); ++k) {
+            totalWrong += table.Has(keys[k]) != (k % 2 == 0);
+        }
+        if (totalWrong != 0) {
+            fail(name + ": wrong lookup result for a key untouched by writers");
+        }
+        print_result(name + ", threads = " + std::to_string(numThreads), numOperations * numThreads, seconds);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_BENCHMARK_LENGTH;
+    if (!n) {
+        fail("n should be greater than 0");
+    }
+
+    // Без повторов: каждая вставка добавляет ключ.
+    auto keys = make_keys(n, 42);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(7));
+
+    auto missingKeys = make_keys(keys.size(), 43);
+    for (auto &key : missingKeys) {
+        key[0] = 'K';
+    }
+
+    benchmark_table<HashTable<std::string, StrCmp, StrHash>>("HashTable", keys, missingKeys);
+    benchmark_table<RobinHoodHashTable<std::string, StrCmp, StrHash>>("RobinHoodHashTable", keys, missingKeys);
+    benchmark_table<StdTable>("std::unordered_set", keys, missingKeys);
+    benchmark_load_factor(keys, missingKeys);
+
+    std::cout << "--- resize, time per moved item ---" << std::endl;
+    benchmark_resize<HashTable<std::string, StrCmp, StrHash>>("HashTable", keys, HASH_MAX_LOAD_FACTOR);
+    benchmark_resize<RobinHoodHashTable<std::string, StrCmp, StrHash>>("RobinHoodHashTable", keys,
+                                                                       ROBIN_HOOD_MAX_LOAD_FACTOR);
+    // Перестройка ConcurrentHashTable останавливает писателей на всё это время.
+    benchmark_resize<ConcurrentHashTable<std::string, StrCmp, StrHash>>("ConcurrentHashTable", keys,
+                                                                        HASH_MAX_LOAD_FACTOR);
+
+    const keys_t sharedKeys(keys.begin(), keys.begin() + std::min<size_t>(keys.size(), CONCURRENT_BENCHMARK_MAX_KEYS));
+    for (auto readPercent : {90, 50}) {
+        std::cout << "--- " << readPercent << "% reads, " << 100 - readPercent << "% writes, n = "
+                  << sharedKeys.size() << ", time per operation ---" << std::endl;
+        benchmark_concurrent<LockedHashTable>("HashTable + mutex", sharedKeys, readPercent);
+        benchmark_concurrent<ConcurrentHashTable<std::string, StrCmp, StrHash>>("ConcurrentHashTable", sharedKeys,
+                                                                                readPercent);
+    }
+
+    return 0;
+}
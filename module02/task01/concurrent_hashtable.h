@@ -0,0 +1,501 @@
+#ifndef CONCURRENT_HASHTABLE_H
+#define CONCURRENT_HASHTABLE_H
+
+#include "hashtable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <exception>
+
+#define EPOCH_MAX_THREADS 256
+#define EPOCH_RECLAIM_BATCH 64
+#define EPOCH_INACTIVE UINT64_MAX
+#define CONCURRENT_HASH_STRIPES 64
+#define CONCURRENT_HASH_MIN_CAPACITY 1024
+#define CONCURRENT_HASH_CACHE_LINE 64
+
+class TooManyThreadsException : public std::exception {
+public:
+    const char *what() const noexcept override {
+        return "Too many threads use epoch-based reclamation.";
+    }
+};
+
+// Освобождение памяти по эпохам: читатель на время операции публикует
+// глобальную эпоху, которую застал при входе. Объект, недоступный из таблицы,
+// получает номер текущей эпохи при удалении и освобождается, когда все
+// активные потоки вошли позже, - ни один из них уже не может держать на него
+// указатель. Удалённые объекты копятся в списке своего потока; раз в
+// EPOCH_RECLAIM_BATCH удалений поток продвигает эпоху и освобождает свои
+// объекты, поэтому общая эпоха меняется редко и удаления не делят мьютекс.
+class EpochManager {
+public:
+    EpochManager() = default;
+    EpochManager(const EpochManager &manager) = delete;
+    EpochManager(EpochManager &&manager) = delete;
+
+    ~EpochManager();
+
+    EpochManager& operator =(const EpochManager &manager) = delete;
+    EpochManager& operator =(EpochManager &&manager) = delete;
+
+    static EpochManager& Instance();
+
+    void Enter();
+    void Leave();
+
+    // pointer уже недоступен для потоков, вошедших после этого вызова.
+    void Retire(void *pointer, void (*deleter)(void *pointer));
+
+private:
+    struct alignas(CONCURRENT_HASH_CACHE_LINE) thread_record_t {
+        std::atomic<uint64_t> epoch{EPOCH_INACTIVE};
+        std::atomic<bool> isUsed{false};
+    };
+
+    typedef struct {
+        void *pointer;
+        void (*deleter)(void *pointer);
+        uint64_t epoch;
+    } retired_t;
+
+    // Запись потока занимается при первой операции и освобождается при его
+    // завершении. Объекты, которые к этому времени ещё нельзя освободить,
+    // переходят в общий список и достаются следующему освобождающему потоку.
+    class ThreadSlot {
+    public:
+        explicit ThreadSlot(EpochManager &manager);
+        ThreadSlot(const ThreadSlot &slot) = delete;
+
+        ~ThreadSlot();
+
+        ThreadSlot& operator =(const ThreadSlot &slot) = delete;
+
+        thread_record_t &GetRecord() const;
+        void Retire(const retired_t &item);
+
+    private:
+        EpochManager &manager;
+        thread_record_t *record;
+        std::vector<retired_t> retired;
+        size_t reclaimSize;
+
+        void Reclaim();
+    };
+
+    std::atomic<uint64_t> globalEpoch{1};
+    thread_record_t records[EPOCH_MAX_THREADS];
+
+    std::mutex orphansMutex;
+    std::vector<retired_t> orphans;
+
+    ThreadSlot &GetSlot();
+    uint64_t GetMinEpoch() const;
+};
+
+class EpochGuard {
+public:
+    EpochGuard();
+    EpochGuard(const EpochGuard &guard) = delete;
+
+    ~EpochGuard();
+
+    EpochGuard& operator =(const EpochGuard &guard) = delete;
+};
+
+// Хеш-таблица с открытой адресацией для одновременного доступа из многих потоков.
+// Слоты - атомарные указатели на неизменяемые узлы {хеш, элемент}.
+// Has не берёт блокировок: читает слоты атомарно, а узлы, удалённые
+// параллельно, освобождаются только после его выхода (EpochManager).
+// Изменения ключа идут под одним из CONCURRENT_HASH_STRIPES мьютексов,
+// выбранным по хешу, поэтому один ключ не меняют два потока сразу, а за
+// пустой слот потоки с разными ключами соревнуются через CAS. Перестройка
+// берёт все мьютексы и переносит указатели на узлы в новый буфер;
+// читатели в это время продолжают работать со старым буфером, который не
+// меняется, и переходят на новый после его публикации. Писатели же ждут
+// конца перестройки: она не делится на части, и при миллионе элементов
+// вставки и удаления стоят десятки миллисекунд.
+template <typename T, typename C = Comparator<T>, typename H = Hash<T>>
+class ConcurrentHashTable {
+public:
+    ConcurrentHashTable();
+    ConcurrentHashTable(const ConcurrentHashTable &hashTable) = delete;
+    ConcurrentHashTable(ConcurrentHashTable &&hashTable) = delete;
+
+    // Вызывается, когда другие потоки уже не обращаются к таблице.
+    ~ConcurrentHashTable();
+
+    ConcurrentHashTable& operator =(const ConcurrentHashTable &hashTable) = delete;
+    ConcurrentHashTable& operator =(ConcurrentHashTable &&hashTable) = delete;
+
+    bool TryAdd(const T &item);
+    bool TryDelete(const T &item);
+    bool Has(const T &item) const;
+
+    size_t GetNumItems() const;
+
+private:
+    typedef struct {
+        uint64_t hash;
+        T item;
+    } node_t;
+
+    typedef struct {
+        size_t capacity;
+        std::atomic<node_t*> *slots;
+    } table_t;
+
+    struct alignas(CONCURRENT_HASH_CACHE_LINE) stripe_t {
+        std::mutex mutex;
+    };
+
+    std::atomic<table_t*> table;
+    mutable stripe_t stripes[CONCURRENT_HASH_STRIPES];
+
+    // Занятые слоты - элементы и метки удаления: от них зависит длина поиска.
+    std::atomic<size_t> numItems{0};
+    std::atomic<size_t> numUsed{0};
+
+    H hash{};
+    C comparator{};
+
+    static node_t *GetTombstone();
+    std::mutex &GetStripe(uint64_t hashValue) const;
+    bool Find(const table_t *table, const T &item, uint64_t hashValue, size_t &index) const;
+
+    bool ShouldResize(const table_t *table) const;
+    void Resize(const table_t *oldTable);
+
+    static table_t *NewTable(size_t capacity);
+    static void DeleteTable(void *pointer);
+    static void DeleteNode(void *pointer);
+};
+
+inline EpochManager::~EpochManager() {
+    for (auto &item : orphans) {
+        item.deleter(item.pointer);
+    }
+}
+
+inline EpochManager &EpochManager::Instance() {
+    static EpochManager manager;
+    return manager;
+}
+
+// Поток, удаляющий узел, заменяет его в слоте и затем читает записи эпох, а
+// читатель записывает эпоху и затем читает буфер и слоты. Если бы хоть одна из
+// этих операций была слабее seq_cst, оба могли бы не увидеть запись другого
+// (store buffering); когда все они seq_cst, либо удаляющий увидит эпоху
+// читателя, либо читатель - слот без узла.
+inline void EpochManager::Enter() {
+    GetSlot().GetRecord().epoch.store(globalEpoch.load());
+}
+
+inline void EpochManager::Leave() {
+    GetSlot().GetRecord().epoch.store(EPOCH_INACTIVE, std::memory_order_release);
+}
+
+inline void EpochManager::Retire(void *pointer, void (*deleter)(void *pointer)) {
+    GetSlot().Retire({pointer, deleter, globalEpoch.load()});
+}
+
+inline EpochManager::ThreadSlot &EpochManager::GetSlot() {
+    static thread_local ThreadSlot slot(*this);
+    return slot;
+}
+
+inline uint64_t EpochManager::GetMinEpoch() const {
+    auto minEpoch = EPOCH_INACTIVE;
+    for (const auto &record : records) {
+        minEpoch = std::min(minEpoch, record.epoch.load());
+    }
+    return minEpoch;
+}
+
+inline EpochManager::ThreadSlot::ThreadSlot(EpochManager &manager) :
+        manager(manager), record(nullptr), reclaimSize(EPOCH_RECLAIM_BATCH) {
+    for (auto &candidate : manager.records) {
+        bool isUsed = false;
+        if (candidate.isUsed.compare_exchange_strong(isUsed, true)) {
+            record = &candidate;
+            return;
+        }
+    }
+    throw TooManyThreadsException();
+}
+
+inline EpochManager::ThreadSlot::~ThreadSlot() {
+    record->epoch.store(EPOCH_INACTIVE);
+    record->isUsed.store(false, std::memory_order_release);
+
+    if (!retired.empty()) {
+        std::lock_guard<std::mutex> lock(manager.orphansMutex);
+        manager.orphans.insert(manager.orphans.end(), retired.begin(), retired.end());
+    }
+}
+
+inline EpochManager::thread_record_t &EpochManager::ThreadSlot::GetRecord() const {
+    return *record;
+}
+
+inline void EpochManager::ThreadSlot::Retire(const retired_t &item) {
+    retired.push_back(item);
+    if (retired.size() >= reclaimSize) {
+        Reclaim();
+    }
+}
+
+// Следующее освобождение - когда список вырастет вдвое: если какой-то поток
+// надолго застрял в операции, удаление всё равно в среднем стоит O(1).
+inline void EpochManager::ThreadSlot::Reclaim() {
+    std::unique_lock<std::mutex> lock(manager.orphansMutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        retired.insert(retired.end(), manager.orphans.begin(), manager.orphans.end());
+        manager.orphans.clear();
+        lock.unlock();
+    }
+
+    manager.globalEpoch.fetch_add(1);
+    const auto minEpoch = manager.GetMinEpoch();
+
+    size_t numKept = 0;
+    for (auto &item : retired) {
+        if (item.epoch < minEpoch) {
+            item.deleter(item.pointer);
+        }
+        else {
+            retired[numKept++] = item;
+        }
+    }
+    retired.resize(numKept);
+    reclaimSize = std::max<size_t>(EPOCH_RECLAIM_BATCH, numKept * 2);
+}
+
+inline EpochGuard::EpochGuard() {
+    EpochManager::Instance().Enter();
+}
+
+inline EpochGuard::~EpochGuard() {
+    EpochManager::Instance().Leave();
+}
+
+template<typename T, typename C, typename H>
+ConcurrentHashTable<T, C, H>::ConcurrentHashTable() : table(NewTable(CONCURRENT_HASH_MIN_CAPACITY)) {
+}
+
+template<typename T, typename C, typename H>
+ConcurrentHashTable<T, C, H>::~ConcurrentHashTable() {
+    auto current = table.load();
+    for (size_t i = 0; i < current->capacity; ++i) {
+        auto node = current->slots[i].load();
+        if (node != nullptr && node != GetTombstone()) {
+            delete node;
+        }
+    }
+    DeleteTable(current);
+}
+
+template<typename T, typename C, typename H>
+bool ConcurrentHashTable<T, C, H>::TryAdd(const T &item) {
+    const auto hashValue = hash.Get(item);
+
+    // Буфер, заполненный сверх порога, перестраивается до вставки: иначе
+    // писатели, успевающие взять мьютексы раньше перестройки, заполнили бы его.
+    // Вне EpochGuard буфер может быть уже освобождён, поэтому дальше
+    // используется только его адрес.
+    table_t *current = nullptr;
+    bool shouldResize = false;
+    {
+        EpochGuard guard;
+        current = table.load();
+        shouldResize = ShouldResize(current);
+    }
+    if (shouldResize) {
+        Resize(current);
+    }
+
+    auto node = new node_t{hashValue, item};
+    while (true) {
+        bool wasPlaced = false;
+        {
+            std::lock_guard<std::mutex> lock(GetStripe(hashValue));
+            EpochGuard guard;
+
+            // Пока взят мьютекс, перестройка не начнётся и буфер не сменится.
+            current = table.load(std::memory_order_acquire);
+            size_t index = 0;
+            if (Find(current, item, hashValue, index)) {
+                delete node;
+                return false;
+            }
+
+            // Этот ключ не вставит никто другой, но свободный слот может занять
+            // поток с другим ключом - тогда берётся следующий свободный.
+            const size_t mask = current->capacity - 1;
+            auto i = static_cast<size_t>(hashValue) & mask;
+            for (size_t j = 0; j < current->capacity && !wasPlaced; ++j, i = (i + 1) & mask) {
+                auto expected = current->slots[i].load(std::memory_order_acquire);
+                if (expected != nullptr && expected != GetTombstone()) {
+                    continue;
+                }
+                wasPlaced = current->slots[i].compare_exchange_strong(expected, node, std::memory_order_acq_rel);
+                if (wasPlaced && expected == nullptr) {
+                    numUsed.fetch_add(1);
+                }
+            }
+            if (wasPlaced) {
+                numItems.fetch_add(1);
+                shouldResize = ShouldResize(current);
+            }
+        }
+
+        // Свободных слотов не осталось: писатели с других мьютексов заполнили
+        // буфер раньше, чем его успели перестроить. Узел ещё никому не виден.
+        if (!wasPlaced) {
+            Resize(current);
+            continue;
+        }
+        if (shouldResize) {
+            Resize(current);
+        }
+        return true;
+    }
+}
+
+template<typename T, typename C, typename H>
+bool ConcurrentHashTable<T, C, H>::TryDelete(const T &item) {
+    const auto hashValue = hash.Get(item);
+    std::lock_guard<std::mutex> lock(GetStripe(hashValue));
+    EpochGuard guard;
+
+    auto current = table.load(std::memory_order_acquire);
+    size_t index = 0;
+    if (!Find(current, item, hashValue, index)) {
+        return false;
+    }
+
+    auto node = current->slots[index].exchange(GetTombstone());
+    numItems.fetch_sub(1);
+    EpochManager::Instance().Retire(node, DeleteNode);
+    return true;
+}
+
+template<typename T, typename C, typename H>
+bool ConcurrentHashTable<T, C, H>::Has(const T &item) const {
+    const auto hashValue = hash.Get(item);
+    EpochGuard guard;
+
+    size_t index = 0;
+    return Find(table.load(), item, hashValue, index);
+}
+
+template<typename T, typename C, typename H>
+size_t ConcurrentHashTable<T, C, H>::GetNumItems() const {
+    return numItems.load();
+}
+
+// Узлы выровнены, поэтому адрес 1 не совпадает ни с одним узлом.
+template<typename T, typename C, typename H>
+typename ConcurrentHashTable<T, C, H>::node_t *ConcurrentHashTable<T, C, H>::GetTombstone() {
+    return reinterpret_cast<node_t*>(uintptr_t(1));
+}
+
+template<typename T, typename C, typename H>
+std::mutex &ConcurrentHashTable<T, C, H>::GetStripe(uint64_t hashValue) const {
+    return stripes[(hashValue >> 32) % CONCURRENT_HASH_STRIPES].mutex;
+}
+
+template<typename T, typename C, typename H>
+bool ConcurrentHashTable<T, C, H>::Find(const table_t *table, const T &item, uint64_t hashValue,
+                                         size_t &index) const {
+    const size_t mask = table->capacity - 1;
+    auto i = static_cast<size_t>(hashValue) & mask;
+
+    // Чтения seq_cst - см. EpochManager::Enter.
+    for (size_t j = 0; j < table->capacity; ++j) {
+        const auto node = table->slots[i].load();
+        if (node == nullptr) {
+            return false;
+        }
+        if (node != GetTombstone() && node->hash == hashValue && comparator.ApplyTo(node->item, item) == 0) {
+            index = i;
+            return true;
+        }
+        i = (i + 1) & mask;
+    }
+    return false;
+}
+
+template<typename T, typename C, typename H>
+bool ConcurrentHashTable<T, C, H>::ShouldResize(const table_t *table) const {
+    return (double)numUsed.load() / table->capacity > HASH_MAX_LOAD_FACTOR;
+}
+
+// Если больше трети занятых слотов - метки удаления, буфер перестраивается
+// без увеличения.
+template<typename T, typename C, typename H>
+void ConcurrentHashTable<T, C, H>::Resize(const table_t *oldTable) {
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(CONCURRENT_HASH_STRIPES);
+    for (auto &stripe : stripes) {
+        locks.emplace_back(stripe.mutex);
+    }
+
+    // Другой поток мог перестроить буфер, пока мы ждали мьютексы; oldTable
+    // тогда мог быть освобождён, и сравнивается только адрес.
+    auto current = table.load();
+    if (current != oldTable || !ShouldResize(current)) {
+        return;
+    }
+
+    const auto items = numItems.load();
+    const auto newCapacity = (numUsed.load() - items) * 3 > numUsed.load() ? current->capacity
+                                                                             : current->capacity * 2;
+    auto newTable = NewTable(newCapacity);
+    const size_t mask = newCapacity - 1;
+    for (size_t i = 0; i < current->capacity; ++i) {
+        auto node = current->slots[i].load(std::memory_order_relaxed);
+        if (node == nullptr || node == GetTombstone()) {
+            continue;
+        }
+
+        auto j = static_cast<size_t>(node->hash) & mask;
+        while (newTable->slots[j].load(std::memory_order_relaxed) != nullptr) {
+            j = (j + 1) & mask;
+        }
+        newTable->slots[j].store(node, std::memory_order_relaxed);
+    }
+
+    numUsed.store(items);
+    table.store(newTable);
+
+    locks.clear();
+    EpochManager::Instance().Retire(current, DeleteTable);
+}
+
+template<typename T, typename C, typename H>
+typename ConcurrentHashTable<T, C, H>::table_t *ConcurrentHashTable<T, C, H>::NewTable(size_t capacity) {
+    auto newTable = new table_t{capacity, new std::atomic<node_t*>[capacity]};
+    for (size_t i = 0; i < capacity; ++i) {
+        newTable->slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return newTable;
+}
+
+template<typename T, typename C, typename H>
+void ConcurrentHashTable<T, C, H>::DeleteTable(void *pointer) {
+    auto oldTable = static_cast<table_t*>(pointer);
+    delete[] oldTable->slots;
+    delete oldTable;
+}
+
+template<typename T, typename C, typename H>
+void ConcurrentHashTable<T, C, H>::DeleteNode(void *pointer) {
+    delete static_cast<node_t*>(pointer);
+}
+
+#endif //CONCURRENT_HASHTABLE_H
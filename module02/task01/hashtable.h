@@ -4,10 +4,20 @@
 #include "container.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <memory>
 #include <cassert>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define HASH_MAX_LOAD_FACTOR 0.75
+#define HASH_GROUP_WIDTH 16
+#define CONTROL_EMPTY ((int8_t)-128)
+#define CONTROL_DELETED ((int8_t)-2)
+#define CONTROL_HASH_MASK 0x7F
+
 template <typename T>
 class Hash {
 public:
@@ -20,9 +30,34 @@ public:
     Hash& operator =(const Hash &hash) = default;
     Hash& operator =(Hash &&hash) noexcept = default;
 
-    virtual size_t Get(const T &item, size_t bufSize) const = 0;
+    // Хеш полной ширины, не зависящий от размера буфера: таблица сама
+    // берёт из него номер слота, поэтому все биты должны быть перемешаны.
+    virtual uint64_t Get(const T &item) const = 0;
+};
+
+// Байты управления группы из HASH_GROUP_WIDTH слотов: CONTROL_EMPTY,
+// CONTROL_DELETED или 7 бит хеша ключа. Каждая проверка сравнивает всю
+// группу одной SSE2-инструкцией и возвращает маску подходящих слотов.
+class ControlGroup {
+public:
+    explicit ControlGroup(const int8_t *controls);
+
+    uint32_t Match(int8_t hashBits) const;
+    uint32_t MatchEmpty() const;
+    uint32_t MatchEmptyOrDeleted() const;
+
+private:
+#ifdef __SSE2__
+    __m128i controls;
+#else
+    const int8_t *controls;
+#endif
 };
 
+// Открытая адресация с плоским хранением: элементы лежат прямо в буфере
+// слотов, рядом - массив байтов управления. Поиск идёт по группам из
+// HASH_GROUP_WIDTH слотов с квадратичным шагом между группами; строки
+// сравниваются только в слотах, где совпали 7 бит хеша и затем весь хеш.
 template <typename T, typename C = Comparator<T>, typename H = Hash<T>>
 class HashTable {
 public:
@@ -46,17 +81,29 @@ public:
     HashTable& operator >>(const T &item);
 
 private:
-    static const size_t MIN_BUFFER_SIZE = 8;
+    static const size_t MIN_BUFFER_SIZE = HASH_GROUP_WIDTH;
 
-    using buffer_node_t = std::shared_ptr<T>;
-    using buffer_t = std::vector<buffer_node_t>;
+    // Полный хеш хранится рядом с элементом: при перестройке буфера ключи
+    // не читаются и не хешируются заново.
+    typedef struct {
+        uint64_t hash;
+        T item;
+    } slot_t;
+
+    using buffer_t = std::vector<slot_t>;
+    using controls_t = std::vector<int8_t>;
 
     size_t numItems = 0;
+    size_t numDeleted = 0;
     buffer_t buffer = buffer_t(MIN_BUFFER_SIZE);
+    controls_t controls = controls_t(MIN_BUFFER_SIZE, CONTROL_EMPTY);
 
     H hash{};
     C comparator{};
 
+    bool Find(const T &item, uint64_t hashValue, size_t &index) const;
+    static size_t FindFreeSlot(const controls_t &controls, uint64_t hashValue);
+
     bool ShouldIncBuffer() const;
     bool ShouldDecBuffer() const;
 
@@ -65,6 +112,48 @@ private:
     void ResizeBuffer(size_t newSize);
 };
 
+#ifdef __SSE2__
+inline ControlGroup::ControlGroup(const int8_t *controls)
+        : controls(_mm_loadu_si128(reinterpret_cast<const __m128i*>(controls))) {
+}
+
+inline uint32_t ControlGroup::Match(int8_t hashBits) const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(hashBits))));
+}
+
+inline uint32_t ControlGroup::MatchEmpty() const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(CONTROL_EMPTY))));
+}
+
+// Занятые слоты неотрицательны, CONTROL_EMPTY и CONTROL_DELETED меньше -1.
+inline uint32_t ControlGroup::MatchEmptyOrDeleted() const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), controls)));
+}
+#else
+inline ControlGroup::ControlGroup(const int8_t *controls) : controls(controls) {
+}
+
+inline uint32_t ControlGroup::Match(int8_t hashBits) const {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < HASH_GROUP_WIDTH; ++i) {
+        mask |= static_cast<uint32_t>(controls[i] == hashBits) << i;
+    }
+    return mask;
+}
+
+inline uint32_t ControlGroup::MatchEmpty() const {
+    return Match(CONTROL_EMPTY);
+}
+
+inline uint32_t ControlGroup::MatchEmptyOrDeleted() const {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < HASH_GROUP_WIDTH; ++i) {
+        mask |= static_cast<uint32_t>(controls[i] < -1) << i;
+    }
+    return mask;
+}
+#endif
+
 template<typename T, typename C, typename H>
 HashTable<T, C, H> &HashTable<T, C, H>::Add(const T &item) {
     TryAdd(item);
@@ -79,93 +168,58 @@ HashTable<T, C, H> &HashTable<T, C, H>::Remove(const T &item) {
 
 template<typename T, typename C, typename H>
 bool HashTable<T, C, H>::TryAdd(const T &item) {
-    size_t index = hash.Get(item, buffer.size());
-    assert(index >= 0 && index < buffer.size());
-
-    int64_t delIndex = -1;
-
-    for (size_t i = 1; i <= buffer.size(); ++i) {
-        if (buffer[index] == nullptr) {
-            buffer[index] = std::make_shared<T>(item);
-            ++numItems;
-            if (ShouldIncBuffer()) {
-                IncBuffer();
-            }
-            return true;
-        }
-        else if (comparator.IsDeleted(*(buffer[index]))) {
-            if (delIndex == -1) {
-                delIndex = index;
-            }
-            index = (index + i) % buffer.size();
-        }
-        else {
-            if (comparator.ApplyTo(*(buffer[index]), item) == 0) {
-                return false;
-            }
-            index = (index + i) % buffer.size();
-        }
+    const auto hashValue = hash.Get(item);
+    size_t index = 0;
+    if (Find(item, hashValue, index)) {
+        return false;
     }
 
-    if (delIndex != -1) {
-        buffer[delIndex] = std::make_shared<T>(item);
-        ++numItems;
-        if (ShouldIncBuffer()) {
-            IncBuffer();
-        }
-        return true;
+    index = FindFreeSlot(controls, hashValue);
+    if (controls[index] == CONTROL_DELETED) {
+        --numDeleted;
     }
+    controls[index] = static_cast<int8_t>(hashValue & CONTROL_HASH_MASK);
+    buffer[index].hash = hashValue;
+    buffer[index].item = item;
+    ++numItems;
 
-    return false;
+    if (ShouldIncBuffer()) {
+        IncBuffer();
+    }
+    return true;
 }
 
 template<typename T, typename C, typename H>
 bool HashTable<T, C, H>::TryDelete(const T &item) {
-    size_t index = hash.Get(item, buffer.size());
-    assert(index >= 0 && index < buffer.size());
-    for (size_t i = 1; i <= buffer.size(); ++i) {
-        if (buffer[index] == nullptr) {
-            return false;
-        }
-        else if (comparator.IsDeleted(*(buffer[index]))) {
-            index = (index + i) % buffer.size();
-        }
-        else {
-            if (comparator.ApplyTo(*(buffer[index]), item) != 0) {
-                index = (index + i) % buffer.size();
-                continue;
-            }
-            buffer[index] = nullptr;
-            --numItems;
-            if (ShouldDecBuffer()) {
-                DecBuffer();
-            }
-            return true;
-        }
+    size_t index = 0;
+    if (!Find(item, hash.Get(item), index)) {
+        return false;
     }
-    return false;
+
+    // Поиск останавливается на первой группе с пустым слотом, поэтому если
+    // в группе уже есть пустой слот, ни одна цепочка через неё не проходит
+    // и слот можно освободить без метки удаления.
+    const auto groupFirst = index & ~size_t(HASH_GROUP_WIDTH - 1);
+    if (ControlGroup(controls.data() + groupFirst).MatchEmpty()) {
+        controls[index] = CONTROL_EMPTY;
+    }
+    else {
+        controls[index] = CONTROL_DELETED;
+        ++numDeleted;
+    }
+    buffer[index].item = T();
+    --numItems;
+
+    if (ShouldDecBuffer()) {
+        DecBuffer();
+    }
+    return true;
 }
 
 template<typename T, typename C, typename H>
 bool HashTable<T, C, H>::Has(const T &item) {
-    size_t index = hash.Get(item, buffer.size());
-    assert(index >= 0 && index < buffer.size());
-
-    for (size_t i = 1; i <= buffer.size(); ++i) {
-        if (buffer[index] == nullptr) {
-            return false;
-        }
-        else if (comparator.IsDeleted(*(buffer[index]))) {
-            index = (index + i) % buffer.size();
-        }
-        else {
-            if (comparator.ApplyTo(*buffer[index], item) == 0) {
-                return true;
-            }
-            index = (index + i) % buffer.size();
-        }
-    }
-    return false;
+    size_t index = 0;
+    return Find(item, hash.Get(item), index);
 }
 
 template<typename T, typename C, typename H>
@@ -178,9 +232,55 @@ HashTable<T, C, H> &HashTable<T, C, H>::operator>>(const T &item) {
     return Remove(item);
 }
 
+template<typename T, typename C, typename H>
+bool HashTable<T, C, H>::Find(const T &item, uint64_t hashValue, size_t &index) const {
+    const auto hashBits = static_cast<int8_t>(hashValue & CONTROL_HASH_MASK);
+    const size_t groupMask = buffer.size() / HASH_GROUP_WIDTH - 1;
+    auto group = static_cast<size_t>(hashValue >> 7) & groupMask;
+
+    for (size_t i = 1; i <= groupMask + 1; ++i) {
+        const auto groupFirst = group * HASH_GROUP_WIDTH;
+        const ControlGroup controlGroup(controls.data() + groupFirst);
+
+        for (auto mask = controlGroup.Match(hashBits); mask != 0; mask &= mask - 1) {
+            const auto candidate = groupFirst + __builtin_ctz(mask);
+            const auto &slot = buffer[candidate];
+            if (slot.hash == hashValue && comparator.ApplyTo(slot.item, item) == 0) {
+                index = candidate;
+                return true;
+            }
+        }
+        if (controlGroup.MatchEmpty()) {
+            return false;
+        }
+        group = (group + i) & groupMask;
+    }
+    return false;
+}
+
+template<typename T, typename C, typename H>
+size_t HashTable<T, C, H>::FindFreeSlot(const controls_t &controls, uint64_t hashValue) {
+    const size_t groupMask = controls.size() / HASH_GROUP_WIDTH - 1;
+    auto group = static_cast<size_t>(hashValue >> 7) & groupMask;
+
+    for (size_t i = 1; i <= groupMask + 1; ++i) {
+        const auto groupFirst = group * HASH_GROUP_WIDTH;
+        const auto mask = ControlGroup(controls.data() + groupFirst).MatchEmptyOrDeleted();
+        if (mask) {
+            return groupFirst + __builtin_ctz(mask);
+        }
+        group = (group + i) & groupMask;
+    }
+
+    // Заполнение не больше HASH_MAX_LOAD_FACTOR, свободный слот есть всегда.
+    assert(false);
+    return 0;
+}
+
+// Метки удаления удлиняют поиск так же, как элементы, поэтому учитываются в заполнении.
 template <typename T, typename C, typename H>
 bool HashTable<T, C, H>::ShouldIncBuffer() const {
-    return (double)numItems / buffer.size() > 0.75;
+    return (double)(numItems + numDeleted) / buffer.size() > HASH_MAX_LOAD_FACTOR;
 }
 
 template <typename T, typename C, typename H>
@@ -188,9 +288,11 @@ bool HashTable<T, C, H>::ShouldDecBuffer() const {
     return (double)numItems / buffer.size() < 0.25;
 }
 
+// Если больше трети заполнения - метки удаления, буфер перестраивается
+// без увеличения.
 template <typename T, typename C, typename H>
 void HashTable<T, C, H>::IncBuffer() {
-    ResizeBuffer(buffer.size() * 2);
+    ResizeBuffer(numDeleted * 3 > numItems + numDeleted ? buffer.size() : buffer.size() * 2);
 }
 
 template <typename T, typename C, typename H>
@@ -200,32 +302,26 @@ void HashTable<T, C, H>::DecBuffer() {
     }
 }
 
+// Элементы переносятся перемещением вместе с сохранёнными хешами: ключи не
+// хешируются заново, строки не копируются.
 template<typename T, typename C, typename H>
 void HashTable<T, C, H>::ResizeBuffer(size_t newSize) {
-    auto newBuf = buffer_t(newSize, nullptr);
+    auto newBuf = buffer_t(newSize);
+    auto newControls = controls_t(newSize, CONTROL_EMPTY);
 
-    for (auto &node : buffer) {
-        if (node == nullptr || comparator.IsDeleted(*node)) {
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        if (controls[i] < 0) {
             continue;
         }
 
-        size_t index = hash.Get(*node, newSize);
-        assert(index >= 0 && index < newSize);
-
-        bool wasPlaced = false;
-
-        for (size_t i = 1; i <= newSize && !wasPlaced; ++i) {
-            if (newBuf[index] == nullptr) {
-                newBuf[index] = std::make_shared<T>(*node);
-                wasPlaced = true;
-            }
-            else {
-                index = (index + i) % newSize;
-            }
-        }
+        const auto index = FindFreeSlot(newControls, buffer[i].hash);
+        newControls[index] = controls[i];
+        newBuf[index] = std::move(buffer[i]);
     }
 
     buffer = std::move(newBuf);
+    controls = std::move(newControls);
+    numDeleted = 0;
 }
 
-#endif //HASHTABLE_H
\ No newline at end of file
+#endif //HASHTABLE_H
@@ -0,0 +1,243 @@
+#ifndef ROBIN_HOOD_HASHTABLE_H
+#define ROBIN_HOOD_HASHTABLE_H
+
+#include "hashtable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#define ROBIN_HOOD_MAX_LOAD_FACTOR 0.9
+#define ROBIN_HOOD_MAX_DISTANCE UINT8_MAX
+
+// Линейное пробирование по методу Робин Гуда: для каждого слота хранится
+// расстояние элемента от его исходного слота, и вставляемый элемент занимает
+// место элемента, который ближе к своему исходному слоту. Поэтому поиск
+// прекращается, как только расстояние в слоте становится меньше текущего, -
+// промах обходится так же дёшево, как попадание, даже при заполнении 0.9.
+// Удаление сдвигает следующие элементы цепочки на слот назад, меток удаления нет.
+// Полный хеш хранится в слоте: перестройка не читает ключи, а строки
+// сравниваются только при совпадении хешей. По нему же восстанавливается
+// расстояние, не поместившееся в байт, - длинные цепочки одинаковых хешей
+// замедляют поиск, но не увеличивают буфер.
+template <typename T, typename C = Comparator<T>, typename H = Hash<T>>
+class RobinHoodHashTable {
+public:
+    RobinHoodHashTable() = default;
+    RobinHoodHashTable(const RobinHoodHashTable &hashTable) = delete;
+    RobinHoodHashTable(RobinHoodHashTable &&hashTable) noexcept = default;
+
+    ~RobinHoodHashTable() noexcept = default;
+
+    RobinHoodHashTable& operator =(const RobinHoodHashTable &hashTable) = delete;
+    RobinHoodHashTable& operator =(RobinHoodHashTable &&hashTable) noexcept = default;
+
+    RobinHoodHashTable& Add(const T &item);
+    RobinHoodHashTable& Remove(const T &item);
+
+    bool TryAdd(const T &item);
+    bool TryDelete(const T &item);
+    bool Has(const T &item);
+
+    RobinHoodHashTable& operator <<(const T &item);
+    RobinHoodHashTable& operator >>(const T &item);
+
+private:
+    static const size_t MIN_BUFFER_SIZE = 8;
+
+    typedef struct {
+        uint64_t hash;
+        T item;
+    } slot_t;
+
+    using buffer_t = std::vector<slot_t>;
+    // 0 - пустой слот, иначе расстояние от исходного слота плюс один;
+    // ROBIN_HOOD_MAX_DISTANCE - расстояние не меньше этого, и оно считается по хешу.
+    using distances_t = std::vector<uint8_t>;
+
+    size_t numItems = 0;
+    buffer_t buffer = buffer_t(MIN_BUFFER_SIZE);
+    distances_t distances = distances_t(MIN_BUFFER_SIZE, 0);
+
+    H hash{};
+    C comparator{};
+
+    size_t GetDistance(size_t index) const;
+    void SetDistance(size_t index, size_t distance);
+
+    bool Find(const T &item, uint64_t hashValue, size_t &index) const;
+    void Insert(slot_t &&slot);
+
+    bool ShouldIncBuffer() const;
+    bool ShouldDecBuffer() const;
+
+    void IncBuffer();
+    void DecBuffer();
+    void ResizeBuffer(size_t newSize);
+};
+
+template<typename T, typename C, typename H>
+RobinHoodHashTable<T, C, H> &RobinHoodHashTable<T, C, H>::Add(const T &item) {
+    TryAdd(item);
+    return *this;
+}
+
+template<typename T, typename C, typename H>
+RobinHoodHashTable<T, C, H> &RobinHoodHashTable<T, C, H>::Remove(const T &item) {
+    TryDelete(item);
+    return *this;
+}
+
+template<typename T, typename C, typename H>
+bool RobinHoodHashTable<T, C, H>::TryAdd(const T &item) {
+    const auto hashValue = hash.Get(item);
+    size_t index = 0;
+    if (Find(item, hashValue, index)) {
+        return false;
+    }
+
+    Insert({hashValue, item});
+    ++numItems;
+
+    if (ShouldIncBuffer()) {
+        IncBuffer();
+    }
+    return true;
+}
+
+template<typename T, typename C, typename H>
+bool RobinHoodHashTable<T, C, H>::TryDelete(const T &item) {
+    size_t index = 0;
+    if (!Find(item, hash.Get(item), index)) {
+        return false;
+    }
+
+    // Элементы за удалённым, стоящие не на своём исходном слоте, сдвигаются
+    // на слот назад до первого пустого слота или элемента на своём месте.
+    const size_t mask = buffer.size() - 1;
+    for (auto next = (index + 1) & mask; distances[next] > 1; next = (next + 1) & mask) {
+        const auto distance = GetDistance(next);
+        buffer[index] = std::move(buffer[next]);
+        SetDistance(index, distance - 1);
+        index = next;
+    }
+    buffer[index].item = T();
+    distances[index] = 0;
+    --numItems;
+
+    if (ShouldDecBuffer()) {
+        DecBuffer();
+    }
+    return true;
+}
+
+template<typename T, typename C, typename H>
+bool RobinHoodHashTable<T, C, H>::Has(const T &item) {
+    size_t index = 0;
+    return Find(item, hash.Get(item), index);
+}
+
+template<typename T, typename C, typename H>
+RobinHoodHashTable<T, C, H> &RobinHoodHashTable<T, C, H>::operator<<(const T &item) {
+    return Add(item);
+}
+
+template<typename T, typename C, typename H>
+RobinHoodHashTable<T, C, H> &RobinHoodHashTable<T, C, H>::operator>>(const T &item) {
+    return Remove(item);
+}
+
+template<typename T, typename C, typename H>
+size_t RobinHoodHashTable<T, C, H>::GetDistance(size_t index) const {
+    if (distances[index] < ROBIN_HOOD_MAX_DISTANCE) {
+        return distances[index];
+    }
+    const size_t mask = buffer.size() - 1;
+    return ((index - static_cast<size_t>(buffer[index].hash)) & mask) + 1;
+}
+
+template<typename T, typename C, typename H>
+void RobinHoodHashTable<T, C, H>::SetDistance(size_t index, size_t distance) {
+    distances[index] = static_cast<uint8_t>(std::min<size_t>(distance, ROBIN_HOOD_MAX_DISTANCE));
+}
+
+// У равных ключей одинаковый исходный слот, поэтому хеши сравниваются
+// только в слотах с тем же расстоянием, а ключи - только при равных хешах.
+template<typename T, typename C, typename H>
+bool RobinHoodHashTable<T, C, H>::Find(const T &item, uint64_t hashValue, size_t &index) const {
+    const size_t mask = buffer.size() - 1;
+    auto i = static_cast<size_t>(hashValue) & mask;
+
+    for (size_t distance = 1;; ++distance) {
+        const auto slotDistance = GetDistance(i);
+        if (slotDistance < distance) {
+            return false;
+        }
+        const auto &slot = buffer[i];
+        if (slotDistance == distance && slot.hash == hashValue && comparator.ApplyTo(slot.item, item) == 0) {
+            index = i;
+            return true;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+template<typename T, typename C, typename H>
+void RobinHoodHashTable<T, C, H>::Insert(slot_t &&slot) {
+    const size_t mask = buffer.size() - 1;
+    auto i = static_cast<size_t>(slot.hash) & mask;
+    size_t distance = 1;
+
+    while (distances[i]) {
+        const auto slotDistance = GetDistance(i);
+        if (slotDistance < distance) {
+            std::swap(slot, buffer[i]);
+            SetDistance(i, distance);
+            distance = slotDistance;
+        }
+        i = (i + 1) & mask;
+        ++distance;
+    }
+    buffer[i] = std::move(slot);
+    SetDistance(i, distance);
+}
+
+template <typename T, typename C, typename H>
+bool RobinHoodHashTable<T, C, H>::ShouldIncBuffer() const {
+    return (double)numItems / buffer.size() > ROBIN_HOOD_MAX_LOAD_FACTOR;
+}
+
+template <typename T, typename C, typename H>
+bool RobinHoodHashTable<T, C, H>::ShouldDecBuffer() const {
+    return (double)numItems / buffer.size() < 0.25;
+}
+
+template <typename T, typename C, typename H>
+void RobinHoodHashTable<T, C, H>::IncBuffer() {
+    ResizeBuffer(buffer.size() * 2);
+}
+
+template <typename T, typename C, typename H>
+void RobinHoodHashTable<T, C, H>::DecBuffer() {
+    if (buffer.size() > MIN_BUFFER_SIZE) {
+        ResizeBuffer(buffer.size() / 2);
+    }
+}
+
+template<typename T, typename C, typename H>
+void RobinHoodHashTable<T, C, H>::ResizeBuffer(size_t newSize) {
+    auto oldBuf = std::move(buffer);
+    auto oldDistances = std::move(distances);
+    buffer = buffer_t(newSize);
+    distances = distances_t(newSize, 0);
+
+    for (size_t i = 0; i < oldBuf.size(); ++i) {
+        if (oldDistances[i]) {
+            Insert(std::move(oldBuf[i]));
+        }
+    }
+}
+
+#endif //ROBIN_HOOD_HASHTABLE_H
@@ -0,0 +1,27 @@
+#ifndef STR_HASH_H
+#define STR_HASH_H
+
+#include <string>
+
+#include "hashtable.h"
+#include "wyhash.h"
+
+class StrCmp : public Comparator<std::string> {
+public:
+    int ApplyTo(const std::string &left, const std::string &right) const override {
+        return left.compare(right);
+    }
+
+    bool IsDeleted(const std::string &item) const override {
+        return item.empty();
+    }
+};
+
+class StrHash : public Hash<std::string> {
+public:
+    uint64_t Get(const std::string &item) const override {
+        return wyhash(item.data(), item.size(), 0);
+    }
+};
+
+#endif //STR_HASH_H
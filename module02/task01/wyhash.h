@@ -0,0 +1,101 @@
+#ifndef WYHASH_H
+#define WYHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// wyhash (final4, Wang Yi, public domain): ключ читается словами по 8 байтов,
+// каждое слово перемешивается одним умножением 64x64 -> 128. Строка до 16
+// байтов - два умножения, дальше - одно на каждые 16 байтов.
+
+#define WYHASH_SECRET_0 0xa0761d6478bd642fULL
+#define WYHASH_SECRET_1 0xe7037ed1a0b428dbULL
+#define WYHASH_SECRET_2 0x8ebc6af09c88c6e3ULL
+#define WYHASH_SECRET_3 0x589965cc75374cc3ULL
+
+inline void wy_multiply(uint64_t &a, uint64_t &b) {
+#ifdef __SIZEOF_INT128__
+    const auto product = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+#else
+    const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    const uint64_t low = t + (rm1 << 32);
+    carry += low < t;
+    a = low;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+inline uint64_t wy_mix(uint64_t a, uint64_t b) {
+    wy_multiply(a, b);
+    return a ^ b;
+}
+
+inline uint64_t wy_read8(const uint8_t *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t wy_read4(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// 1..3 байта: первый, средний и последний.
+inline uint64_t wy_read3(const uint8_t *p, size_t length) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+}
+
+inline uint64_t wyhash(const void *key, size_t length, uint64_t seed) {
+    auto p = static_cast<const uint8_t*>(key);
+    seed ^= wy_mix(seed ^ WYHASH_SECRET_0, WYHASH_SECRET_1);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (length <= 16) {
+        if (length >= 4) {
+            const auto shift = (length >> 3) << 2;
+            a = (wy_read4(p) << 32) | wy_read4(p + shift);
+            b = (wy_read4(p + length - 4) << 32) | wy_read4(p + length - 4 - shift);
+        }
+        else if (length > 0) {
+            a = wy_read3(p, length);
+        }
+    }
+    else {
+        auto i = length;
+        if (i > 48) {
+            auto seed1 = seed;
+            auto seed2 = seed;
+            do {
+                seed = wy_mix(wy_read8(p) ^ WYHASH_SECRET_1, wy_read8(p + 8) ^ seed);
+                seed1 = wy_mix(wy_read8(p + 16) ^ WYHASH_SECRET_2, wy_read8(p + 24) ^ seed1);
+                seed2 = wy_mix(wy_read8(p + 32) ^ WYHASH_SECRET_3, wy_read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_read8(p) ^ WYHASH_SECRET_1, wy_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wy_read8(p + i - 16);
+        b = wy_read8(p + i - 8);
+    }
+
+    a ^= WYHASH_SECRET_1;
+    b ^= seed;
+    wy_multiply(a, b);
+    return wy_mix(a ^ WYHASH_SECRET_0 ^ length, b ^ WYHASH_SECRET_1);
+}
+
+#endif //WYHASH_H